@@ -1,6 +1,12 @@
 /**Inventory System
  This program allows you to manage your inventory by adding new items, listing all items, and displaying help information.
- It uses a CSV file to store the inventory data.
+ It uses a CSV file to store the inventory data. The file is read once at startup into an in-memory store
+ that is indexed by item ID (hash) and by case-folded name (ordered), so commands never re-read it.
+ Reading maps the file into memory and splits it with a SIMD delimiter scan instead of getline.
+ With --sort-memory MB the rows stay in the file instead (only the ID index is kept) and itemslist
+ sorts them with a parallel external merge sort that uses at most that much memory.
+ itemsum answers date-range aggregates from inventory.col, a columnar copy of the CSV that is
+ rebuilt whenever the CSV has changed.
  Required libraries:
  - iostream: for input/output stream operations
  - fstream: for file stream operations
@@ -10,6 +16,17 @@
  - sstream: for string stream operations
  - iomanip: for input/output manipulation operations
  - ctime: for date and time operations
+ - unordered_map: for the item ID index
+ - map: for the ordered name index
+ - locale: for optional locale-aware name collation
+ - chrono, random: for the --bench-sort benchmark
+ - fcntl.h, unistd.h (io.h on Windows): for the buffered appender and fsync
+ - sys/mman.h, emmintrin.h: for the memory-mapped CSV reader (plain reads and a scalar
+   scan where they are not available)
+ - cstring, cstddef: for reading and updating the inventory.col header
+ - string_view: for CSV fields that point into the mapped file
+ - thread, queue, functional: for the external merge sort (build with -pthread)
+ - mutex, condition_variable: for the appender's background flush
 */
 #include <iostream>
 #include <fstream>
@@ -19,6 +36,32 @@
 #include <sstream>
 #include <iomanip>
 #include <ctime>
+#include <unordered_map>
+#include <map>
+#include <locale>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <chrono>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <functional>
+#include <memory>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -30,84 +73,1291 @@ struct Item {
     string registration_date;
 };
 
+// Sort key for an item name, computed once per item. The first 8 bytes of
+// the folded name are packed big-endian into an integer, so most
+// comparisons are a single integer compare; equal prefixes fall back to
+// the full folded string.
+struct CollationKey {
+    uint64_t prefix;
+    string folded;
+};
+
+bool operator<(const CollationKey& a, const CollationKey& b) {
+    if (a.prefix != b.prefix) return a.prefix < b.prefix;
+    return a.folded < b.folded;
+}
+
+// Resident copy of inventory.csv with its two indexes. In external mode
+// only byId is filled (its values are unused) and the rows are read back
+// from the file when they are listed.
+struct InventoryStore {
+    vector<Item> items;                         // In file order
+    unordered_map<string, size_t> byId;         // Item ID -> position in items
+    multimap<CollationKey, size_t> byName;      // Name key -> position in items
+
+    bool external = false;                      // Set by --sort-memory
+    size_t sortMemory = 0;                      // Byte cap for sorting in external mode
+    vector<size_t> rejectedRows;                // Byte offsets of rows the loader skipped
+    uint64_t columnAppendMark = UINT64_MAX;     // Writer's appendedBytes() when inventory.col was
+                                                // last built or confirmed (UINT64_MAX: not yet)
+};
+
+const string INVENTORY_FILE = "inventory.csv";
+const string COLUMN_FILE = "inventory.col";
+
+// Off by default: names are compared byte by byte after ASCII case
+// folding. --locale switches to the user's locale collation rules.
+bool localeCollation = false;
+
 // Function to convert string to lowercase
 string toLower(string str) {
     transform(str.begin(), str.end(), str.begin(), ::tolower);
     return str;
 }
 
+// Function to fold a name for sorting. The ASCII path folds A-Z without a
+// locale lookup and leaves other bytes as they are; the locale path folds
+// and then applies the locale's strxfrm-style transform, so comparing two
+// folded names byte by byte gives the locale's order.
+string foldName(string name) {
+    for (char& c : name) {
+        c += (unsigned char)(c - 'A') < 26 ? 'a' - 'A' : 0;
+    }
+    if (localeCollation) {
+        const collate<char>& rules = use_facet<collate<char>>(locale());
+        name = rules.transform(name.data(), name.data() + name.size());
+    }
+    return name;
+}
+
+// Function to build the collation key of a name
+CollationKey makeCollationKey(const string& name) {
+    CollationKey key;
+    key.folded = foldName(name);
+
+    key.prefix = 0;
+    for (size_t i = 0; i < 8; i++) {
+        unsigned char byte = i < key.folded.size() ? (unsigned char)key.folded[i] : 0;
+        key.prefix = (key.prefix << 8) | byte;
+    }
+    return key;
+}
+
+// Function to put an item into the store; false if its ID is already taken
+bool insertItem(InventoryStore& store, const Item& item) {
+    if (!store.byId.emplace(item.id, store.items.size()).second) {
+        return false;
+    }
+    if (store.external) return true;
+    store.byName.emplace(makeCollationKey(item.name), store.items.size());
+    store.items.push_back(item);
+    return true;
+}
+
+// Read-only view of a whole file: memory-mapped where the platform has
+// mmap, read into a buffer otherwise. A missing or empty file is an empty
+// view.
+class MappedFile {
+public:
+    explicit MappedFile(const string& filename) {
+#ifdef _WIN32
+        ifstream file(filename, ios::binary);
+        fallback.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        bytes = fallback.data();
+        length = fallback.size();
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                madvise(mapped, (size_t)info.st_size, MADV_SEQUENTIAL);
+                bytes = (const char*)mapped;
+                length = (size_t)info.st_size;
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (bytes) munmap((void*)bytes, length);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    string fallback;
+#endif
+};
+
+// One line of a CSV file. Fields point into the reader's buffer and are
+// only valid while it is.
+struct CsvRow {
+    static const size_t MAX_FIELDS = 4;     // Further fields are counted, not kept
+
+    string_view fields[MAX_FIELDS];
+    size_t fieldCount;
+    size_t lineNumber;
+    size_t offset;                          // Byte offset of the line in the file
+};
+
+// Zero-copy CSV splitter. The buffer is scanned 64 bytes at a time for ','
+// and '\n' (four SSE2 compares, or a plain loop without SSE2) into a bit
+// mask, and rows are cut by popping bits off the mask, so there is no
+// per-character branch between delimiters. No quoting: inventory fields
+// never contain commas.
+class CsvReader {
+public:
+    CsvReader(const char* data, size_t size) : data(data), size(size) {
+        if (size > 0) mask = scanBlock(0);
+    }
+
+    // Next non-blank line; false at end of buffer
+    bool next(CsvRow& row) {
+        while (pos < size) {
+            row.fieldCount = 0;
+            row.lineNumber = ++lineNumber;
+            row.offset = pos;
+
+            size_t start = pos;
+            size_t end;
+            do {
+                end = nextDelimiter();
+                if (row.fieldCount < CsvRow::MAX_FIELDS) {
+                    row.fields[row.fieldCount] = string_view(data + start, end - start);
+                }
+                row.fieldCount++;
+                start = end + 1;
+            } while (end < size && data[end] != '\n');
+            pos = min(start, size);
+
+            // Files written on Windows end their lines with \r\n
+            if (row.fieldCount <= CsvRow::MAX_FIELDS) {
+                string_view& last = row.fields[row.fieldCount - 1];
+                if (!last.empty() && last.back() == '\r') last.remove_suffix(1);
+            }
+            if (row.fieldCount == 1 && row.fields[0].empty()) continue;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    const char* data;
+    size_t size;
+    size_t pos = 0;             // Start of the next line
+    size_t lineNumber = 0;
+    size_t blockStart = 0;      // Block the mask was taken from
+    uint64_t mask = 0;          // Delimiters in that block not yet consumed
+
+    // Bit i set where data[offset + i] is ',' or '\n'
+    uint64_t scanBlock(size_t offset) const {
+        uint64_t bits = 0;
+        size_t i = 0;
+#ifdef __SSE2__
+        if (size - offset >= 64) {
+            const __m128i comma = _mm_set1_epi8(',');
+            const __m128i newline = _mm_set1_epi8('\n');
+            for (; i < 64; i += 16) {
+                __m128i chunk = _mm_loadu_si128((const __m128i*)(data + offset + i));
+                __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, comma),
+                                            _mm_cmpeq_epi8(chunk, newline));
+                bits |= (uint64_t)(uint16_t)_mm_movemask_epi8(hits) << i;
+            }
+            return bits;
+        }
+#endif
+        size_t n = min<size_t>(64, size - offset);
+        for (; i < n; i++) {
+            char c = data[offset + i];
+            bits |= (uint64_t)(c == ',' || c == '\n') << i;
+        }
+        return bits;
+    }
+
+    // Offset of the next delimiter, or size when there is none
+    size_t nextDelimiter() {
+        while (mask == 0) {
+            blockStart += 64;
+            if (blockStart >= size) return size;
+            mask = scanBlock(blockStart);
+        }
+        size_t offset = blockStart + (size_t)__builtin_ctzll(mask);
+        mask &= mask - 1;
+        return offset;
+    }
+};
+
+// Function to parse a quantity field: optional '-', then up to 10 digits.
+// Every character goes through the same multiply-add; a non-digit only
+// sets a flag that is tested once at the end, so the loop has no
+// data-dependent branch.
+bool parseQuantity(string_view text, int& quantity) {
+    bool negative = !text.empty() && text[0] == '-';
+    text.remove_prefix(negative);
+    if (text.empty() || text.size() > 10) return false;
+
+    uint64_t value = 0;
+    uint32_t invalid = 0;
+    for (char c : text) {
+        uint32_t digit = (uint32_t)(unsigned char)c - '0';
+        invalid |= digit > 9;
+        value = value * 10 + digit;
+    }
+    if (invalid || value > (uint64_t)INT32_MAX + negative) return false;
+    quantity = negative ? (int)(0 - value) : (int)value;
+    return true;
+}
+
+// Function to parse a command-line count: digits only, no sign, no
+// overflow (stoull would throw or wrap instead)
+bool parseCount(const string& text, unsigned long long& value) {
+    if (text.empty() || text.size() > 19 || text.find_first_not_of("0123456789") != string::npos) {
+        return false;
+    }
+    value = stoull(text);
+    return true;
+}
+
+// Function to load the inventory file once at startup. Rows with a bad
+// quantity or a repeated ID are reported and left out of the store.
+void loadInventory(InventoryStore& store, const string& filename) {
+    MappedFile file(filename);
+    CsvReader reader(file.data(), file.size());
+    CsvRow row;
+    vector<pair<CollationKey, size_t>> keys;
+
+    auto skip = [&](const string& reason) {
+        store.rejectedRows.push_back(row.offset);
+        cout << "Warning: skipping line " << row.lineNumber << " (byte " << row.offset
+             << ") of " << filename << " (" << reason << ")\n";
+    };
+
+    while (reader.next(row)) {
+        // Missing fields read as empty, as getline used to leave them
+        for (size_t f = row.fieldCount; f < CsvRow::MAX_FIELDS; f++) row.fields[f] = {};
+        string_view id = row.fields[0];
+
+        int quantity;
+        if (!parseQuantity(row.fields[2], quantity)) {
+            skip("invalid quantity");
+            continue;
+        }
+        if (!store.byId.emplace(id, store.items.size()).second) {
+            skip("duplicate item ID '" + string(id) + "'");
+            continue;
+        }
+        if (store.external) continue;
+        keys.emplace_back(makeCollationKey(string(row.fields[1])), store.items.size());
+        store.items.push_back({string(id), string(row.fields[1]), quantity, string(row.fields[3])});
+    }
+
+    // One sort of the precomputed keys, then an O(n) build of the name
+    // index (ties stay in file order)
+    sort(keys.begin(), keys.end());
+    for (auto& key : keys) {
+        store.byName.emplace_hint(store.byName.end(), move(key.first), key.second);
+    }
+}
+
+// When appended rows are forced to disk with fsync
+enum class SyncPolicy {
+    None,       // Leave it to the operating system
+    Batch,      // Once per flushed group of rows (group commit)
+    Always      // Before every itemadd reports success
+};
+
+struct WriterOptions {
+    size_t maxRows = 1000;          // Flush once this many rows are buffered
+    size_t maxBytes = 64 * 1024;    // ... or this many bytes
+    long long maxDelayMs = 200;     // ... or the oldest row is this old
+    SyncPolicy syncPolicy = SyncPolicy::Batch;
+};
+
+// What happened to a row given to InventoryWriter::append
+enum class AppendStatus {
+    Ok,         // Buffered or written as the sync policy asks
+    Rejected,   // A write failed before any of the row reached the file; it was dropped
+    Unsaved     // Part or all of the row is in the file, but a write or fsync failed;
+                // anything unwritten stays buffered and is retried
+};
+
+// Appender for inventory.csv that keeps the file open and writes buffered
+// rows with one write call per group instead of an open/close per item.
+// While the file is open a flusher thread writes the buffer once its
+// oldest row is maxDelayMs old, so an idle prompt does not hold rows back.
+// A failed write or fsync is retried by the next flush.
+class InventoryWriter {
+public:
+    explicit InventoryWriter(const WriterOptions& options = WriterOptions()) : options(options) {}
+    ~InventoryWriter() { close(); }
+
+    InventoryWriter(const InventoryWriter&) = delete;
+    InventoryWriter& operator=(const InventoryWriter&) = delete;
+
+    bool open(const string& filename) {
+        lock_guard<mutex> guard(lock);
+#ifdef _WIN32
+        fd = _open(filename.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY,
+                   _S_IREAD | _S_IWRITE);
+#else
+        fd = ::open(filename.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+#endif
+        if (fd < 0) return false;
+        stopping = false;
+        flusher = thread(&InventoryWriter::flushWhenDue, this);
+        return true;
+    }
+
+    AppendStatus append(const string& row) {
+        lock_guard<mutex> guard(lock);
+        if (!dirty()) {
+            oldest = chrono::steady_clock::now();
+            wake.notify_one();      // Start the delay clock
+        }
+        buffer += row;
+        bufferedRows++;
+
+        bool ok;
+        if (options.syncPolicy == SyncPolicy::Always) ok = syncLocked();
+        else if (bufferedRows >= options.maxRows || buffer.size() >= options.maxBytes) ok = flushLocked();
+        else ok = flushIfDueLocked();
+        if (ok) return AppendStatus::Ok;
+
+        // The row is last in the buffer; if all of it is still there it
+        // never reached the file and can be taken back
+        if (buffer.size() >= row.size()) {
+            buffer.resize(buffer.size() - row.size());
+            bufferedRows--;
+            return AppendStatus::Rejected;
+        }
+        return AppendStatus::Unsaved;
+    }
+
+    // Flush when the oldest buffered row has waited long enough; also
+    // false when a background flush has failed since the last call
+    bool flushIfDue() {
+        lock_guard<mutex> guard(lock);
+        bool ok = flushIfDueLocked() && !backgroundFailed;
+        backgroundFailed = false;
+        return ok;
+    }
+
+    // Write out the buffered rows; on failure only the bytes that were not
+    // written stay buffered, so a retry never writes a row twice
+    bool flush() {
+        lock_guard<mutex> guard(lock);
+        return flushLocked();
+    }
+
+    // Flush and fsync whatever the policy
+    bool sync() {
+        lock_guard<mutex> guard(lock);
+        return syncLocked();
+    }
+
+    void close() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (flusher.joinable()) flusher.join();
+
+        lock_guard<mutex> guard(lock);
+        if (fd < 0) return;
+        if (!flushLocked()) cout << "Error: could not write " << bufferedRows << " buffered item(s)!\n";
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+        fd = -1;
+    }
+
+    size_t pendingRows() const {
+        lock_guard<mutex> guard(lock);
+        return bufferedRows;
+    }
+
+    // Bytes written to the file since it was opened
+    uint64_t appendedBytes() const {
+        lock_guard<mutex> guard(lock);
+        return bytesAppended;
+    }
+
+private:
+    WriterOptions options;
+    mutable mutex lock;             // Guards everything below
+    condition_variable wake;        // Signals the flusher
+    thread flusher;
+    bool stopping = false;
+    bool backgroundFailed = false;  // Not yet reported by flushIfDue
+    int fd = -1;
+    string buffer;
+    size_t bufferedRows = 0;
+    uint64_t bytesAppended = 0;
+    bool needsSync = false;         // Written since the last successful fsync
+    chrono::steady_clock::time_point oldest;
+
+    // Rows to write, or written rows the policy still wants fsync'd
+    bool dirty() const {
+        return !buffer.empty() || (needsSync && options.syncPolicy != SyncPolicy::None);
+    }
+
+    bool flushIfDueLocked() {
+        if (!dirty()) return true;
+        auto waited = chrono::steady_clock::now() - oldest;
+        if (chrono::duration_cast<chrono::milliseconds>(waited).count() < options.maxDelayMs) {
+            return true;
+        }
+        return flushLocked();
+    }
+
+    bool flushLocked() {
+        if (!buffer.empty()) {
+            if (!writeBuffer()) return false;
+            bufferedRows = 0;
+        }
+        return options.syncPolicy == SyncPolicy::None || !needsSync || syncFile();
+    }
+
+    bool syncLocked() {
+        return flushLocked() && (!needsSync || syncFile());
+    }
+
+    // Sleeps until the oldest buffered row is due, then flushes. A failed
+    // flush is retried after another full delay rather than in a tight loop.
+    void flushWhenDue() {
+        unique_lock<mutex> guard(lock);
+        while (!stopping) {
+            if (!dirty()) {
+                wake.wait(guard);
+                continue;
+            }
+            auto due = oldest + chrono::milliseconds(options.maxDelayMs);
+            if (chrono::steady_clock::now() < due) {
+                wake.wait_until(guard, due);
+                continue;
+            }
+            if (!flushLocked()) {
+                backgroundFailed = true;
+                oldest = chrono::steady_clock::now();
+            }
+        }
+    }
+
+    // Write the buffer and drop what was written, even when a later write fails
+    bool writeBuffer() {
+        size_t written = 0;
+        while (written < buffer.size()) {
+#ifdef _WIN32
+            int n = _write(fd, buffer.data() + written, (unsigned)(buffer.size() - written));
+#else
+            ssize_t n = ::write(fd, buffer.data() + written, buffer.size() - written);
+#endif
+            if (n <= 0) break;
+            written += (size_t)n;
+        }
+        bool complete = written == buffer.size();
+        buffer.erase(0, written);
+        bytesAppended += written;
+        if (written > 0) needsSync = true;
+        return complete;
+    }
+
+    bool syncFile() {
+#ifdef _WIN32
+        bool ok = _commit(fd) == 0;
+#else
+        bool ok = fsync(fd) == 0;
+#endif
+        if (ok) needsSync = false;
+        return ok;
+    }
+};
+
 // Function to add a new item to the inventory
-void addItem(const string& id, const string& name, int quantity, const string& reg_date) {
-    ofstream file("inventory.csv", ios::app);
-    if (file.is_open()) {
-        file << id << "," << name << "," << quantity << "," << reg_date << "\n";
-        file.close();
-        cout << "Item added successfully!\n";
-    } else {
-        cout << "Error opening file!\n";
+void addItem(InventoryStore& store, InventoryWriter& writer, const string& id, const string& name,
+             int quantity, const string& reg_date) {
+    if (store.byId.count(id)) {
+        cout << "Error: Item ID already exists!\n";
+        return;
+    }
+
+    // A row that reached the file is indexed even if the write failed
+    // later, so its ID cannot be added a second time
+    string row = id + "," + name + "," + to_string(quantity) + "," + reg_date + "\n";
+    switch (writer.append(row)) {
+        case AppendStatus::Ok:
+            insertItem(store, {id, name, quantity, reg_date});
+            cout << "Item added successfully!\n";
+            break;
+        case AppendStatus::Unsaved:
+            insertItem(store, {id, name, quantity, reg_date});
+            cout << "Item added, but writing it to file failed; it will be retried.\n";
+            break;
+        case AppendStatus::Rejected:
+            cout << "Error writing to file!\n";
+            break;
+    }
+}
+
+// Functions to print the itemslist table
+void printTableHeader() {
+    cout << "\n| Item ID\t| Item Name\t\t| Quantity\t| Reg Date\t|\n";
+    cout << "|-----------|-----------------------|-----------|------------------|\n";
+}
+
+void printTableRow(string_view id, string_view name, int quantity, string_view date) {
+    cout << "| " << setw(10) << id << "\t| " 
+         << setw(20) << name << "\t| " 
+         << setw(10) << quantity << "\t| " 
+         << setw(10) << date << "\t|\n";
+}
+
+// Function to print one CSV line of inventory.csv as a table row
+void printCsvRow(string_view line) {
+    CsvReader reader(line.data(), line.size());
+    CsvRow row;
+    if (!reader.next(row)) return;
+    for (size_t f = row.fieldCount; f < CsvRow::MAX_FIELDS; f++) row.fields[f] = {};
+    int quantity = 0;
+    parseQuantity(row.fields[2], quantity);
+    printTableRow(row.fields[0], row.fields[1], quantity, row.fields[3]);
+}
+
+// Function to display all items in alphabetical order (walks the name index)
+void listItems(const InventoryStore& store) {
+    printTableHeader();
+    for (const auto& entry : store.byName) {
+        const Item& item = store.items[entry.second];
+        printTableRow(item.id, item.name, item.quantity, item.registration_date);
+    }
+    cout << "\n";
+}
+
+// Streaming scans
+
+// One live row of the inventory. The views point into the store or into
+// the mapped file and are only valid while those are.
+struct RowView {
+    string_view id;
+    string_view name;
+    int quantity;
+    string_view date;
+    string_view line;       // The CSV line in external mode, empty otherwise
+};
+
+// Function to visit every live row in file order: the resident items, or
+// in external mode the rows of file minus the ones the loader skipped
+void scanRows(const InventoryStore& store, const MappedFile& file,
+              const function<void(const RowView&)>& visit) {
+    if (!store.external) {
+        for (const Item& item : store.items) {
+            visit({item.id, item.name, item.quantity, item.registration_date, {}});
+        }
+        return;
+    }
+
+    CsvReader reader(file.data(), file.size());
+    CsvRow row;
+    size_t nextRejected = 0;
+    while (reader.next(row)) {
+        while (nextRejected < store.rejectedRows.size() &&
+               store.rejectedRows[nextRejected] < row.offset) {
+            nextRejected++;
+        }
+        if (nextRejected < store.rejectedRows.size() &&
+            store.rejectedRows[nextRejected] == row.offset) {
+            continue;
+        }
+
+        const string_view& last = row.fields[min(row.fieldCount, CsvRow::MAX_FIELDS) - 1];
+        string_view line(file.data() + row.offset,
+                         last.data() + last.size() - (file.data() + row.offset));
+        for (size_t f = row.fieldCount; f < CsvRow::MAX_FIELDS; f++) row.fields[f] = {};
+        int quantity = 0;
+        parseQuantity(row.fields[2], quantity);
+        visit({row.fields[0], row.fields[1], quantity, row.fields[3], line});
     }
 }
 
-// Function to read and display all items in alphabetical order
-void listItems() {
-    vector<Item> items;
-    ifstream file("inventory.csv");
+// Function to display one page of the alphabetical listing. The resident
+// name index is already sorted, so the page is a walk from offset; in
+// external mode a bounded max-heap keeps the offset + limit smallest
+// names seen so far, O(n log k) time and O(k) memory.
+void listItemsPage(const InventoryStore& store, size_t offset, size_t limit) {
+    printTableHeader();
+    if (!store.external) {
+        auto it = store.byName.begin();
+        for (size_t skipped = 0; skipped < offset && it != store.byName.end(); skipped++) ++it;
+        for (size_t shown = 0; shown < limit && it != store.byName.end(); shown++, ++it) {
+            const Item& item = store.items[it->second];
+            printTableRow(item.id, item.name, item.quantity, item.registration_date);
+        }
+        cout << "\n";
+        return;
+    }
+
+    // (name key, file position) orders ties in file order, as itemslist does
+    typedef pair<pair<CollationKey, size_t>, RowView> Entry;
+    auto earlier = [](const Entry& a, const Entry& b) { return a.first < b.first; };
+    vector<Entry> heap;
+    size_t keep = offset + limit;
+    size_t position = 0;
+
+    MappedFile file(INVENTORY_FILE);
+    scanRows(store, file, [&](const RowView& row) {
+        pair<CollationKey, size_t> key(makeCollationKey(string(row.name)), position++);
+        if (heap.size() == keep) {
+            if (keep == 0 || !(key < heap.front().first)) return;
+            pop_heap(heap.begin(), heap.end(), earlier);
+            heap.pop_back();
+        }
+        heap.emplace_back(move(key), row);
+        push_heap(heap.begin(), heap.end(), earlier);
+    });
+
+    sort_heap(heap.begin(), heap.end(), earlier);
+    for (size_t i = offset; i < heap.size(); i++) {
+        const RowView& row = heap[i].second;
+        printTableRow(row.id, row.name, row.quantity, row.date);
+    }
+    cout << "\n";
+}
+
+// Function to display the count items with the highest quantity, largest
+// first (ties in file order). A min-heap of the best count rows so far
+// is kept over one scan: O(n log k) time and O(k) memory.
+void listTopItems(const InventoryStore& store, size_t count) {
+    typedef pair<int, size_t> Rank;      // (quantity, file position)
+    typedef pair<Rank, RowView> Entry;
+    auto better = [](const Entry& a, const Entry& b) {
+        if (a.first.first != b.first.first) return a.first.first > b.first.first;
+        return a.first.second < b.first.second;
+    };
+    vector<Entry> heap;
+    size_t position = 0;
+
+    MappedFile file(store.external ? INVENTORY_FILE : string());    // Empty unless external
+    scanRows(store, file, [&](const RowView& row) {
+        Entry entry(Rank(row.quantity, position++), row);
+        if (heap.size() == count) {
+            if (count == 0 || !better(entry, heap.front())) return;
+            pop_heap(heap.begin(), heap.end(), better);
+            heap.pop_back();
+        }
+        heap.push_back(entry);
+        push_heap(heap.begin(), heap.end(), better);
+    });
+
+    sort_heap(heap.begin(), heap.end(), better);
+    printTableHeader();
+    for (const Entry& entry : heap) {
+        printTableRow(entry.second.id, entry.second.name, entry.second.quantity, entry.second.date);
+    }
+    cout << "\n";
+}
+
+// External merge sort
+
+// A row waiting to be sorted: its key and the line it came from
+struct SortRecord {
+    CollationKey key;
+    string_view line;       // Points into the mapped file
+};
+
+// A run is spilled as (folded name, line) pairs, each length-prefixed
+void writeSpillField(ofstream& out, string_view text) {
+    uint32_t length = (uint32_t)text.size();
+    out.write((const char*)&length, sizeof(length));
+    out.write(text.data(), length);
+}
+
+// Sorted chunk of rows, sorted and spilled by its own thread
+struct SortJob {
+    vector<SortRecord> records;
+    string filename;
+    bool ok = false;
+    thread worker;
+
+    void run() {
+        stable_sort(records.begin(), records.end(),
+                    [](const SortRecord& a, const SortRecord& b) { return a.key < b.key; });
+        ofstream out(filename, ios::binary);
+        for (const SortRecord& record : records) {
+            writeSpillField(out, record.key.folded);
+            writeSpillField(out, record.line);
+        }
+        ok = (bool)out.flush();
+        records = vector<SortRecord>();
+    }
+};
+
+// Sequential reader of one spilled run with a buffer of its own
+class RunReader {
+public:
+    RunReader(const string& filename, size_t bufferBytes) : buffer(bufferBytes) {
+        in.rdbuf()->pubsetbuf(buffer.data(), (streamsize)buffer.size());
+        in.open(filename, ios::binary);
+    }
+
+    bool next() {
+        if (!readField(key.folded) || !readField(line)) return false;
+        key.prefix = 0;
+        for (size_t i = 0; i < 8; i++) {
+            unsigned char byte = i < key.folded.size() ? (unsigned char)key.folded[i] : 0;
+            key.prefix = (key.prefix << 8) | byte;
+        }
+        return true;
+    }
+
+    CollationKey key;
     string line;
 
-    // Read all items from CSV
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string id, name, quantity_str, date;
-        
-        getline(ss, id, ',');
-        getline(ss, name, ',');
-        getline(ss, quantity_str, ',');
-        getline(ss, date, ',');
+private:
+    vector<char> buffer;
+    ifstream in;
+
+    bool readField(string& text) {
+        uint32_t length;
+        if (!in.read((char*)&length, sizeof(length))) return false;
+        text.resize(length);
+        return (bool)in.read(&text[0], length);
+    }
+};
 
-        Item item = {id, name, stoi(quantity_str), date};
-        items.push_back(item);
+// Function to merge sorted runs into sink in key order. Ties go to the
+// earlier run, so rows with equal names keep their file order. Fan-in is
+// capped; more runs are first merged in groups into longer runs.
+bool mergeRuns(vector<string> runs, size_t memoryBytes,
+               const function<void(const CollationKey&, string_view)>& sink) {
+    const size_t MAX_FAN_IN = 64;
+    int pass = 0;
+
+    while (runs.size() > MAX_FAN_IN) {
+        vector<string> merged;
+        for (size_t first = 0; first < runs.size(); first += MAX_FAN_IN) {
+            vector<string> group(runs.begin() + first,
+                                 runs.begin() + min(runs.size(), first + MAX_FAN_IN));
+            string filename = INVENTORY_FILE + ".merge" + to_string(pass) + "." + to_string(merged.size());
+            ofstream out(filename, ios::binary);
+            bool ok = mergeRuns(group, memoryBytes, [&](const CollationKey& key, string_view line) {
+                writeSpillField(out, key.folded);
+                writeSpillField(out, line);
+            });
+            merged.push_back(filename);
+            if (!ok || !out.flush()) {
+                for (const string& run : merged) remove(run.c_str());
+                return false;
+            }
+        }
+        runs.swap(merged);
+        pass++;
     }
-    file.close();
 
-    // Sort items by name
-    sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
-        return toLower(a.name) < toLower(b.name);
+    size_t bufferBytes = max<size_t>(memoryBytes / (runs.size() + 1), 4096);
+    vector<unique_ptr<RunReader>> readers;
+    auto later = [&](size_t a, size_t b) {
+        if (readers[b]->key < readers[a]->key) return true;
+        if (readers[a]->key < readers[b]->key) return false;
+        return a > b;
+    };
+    priority_queue<size_t, vector<size_t>, decltype(later)> heads(later);
+    for (size_t r = 0; r < runs.size(); r++) {
+        readers.emplace_back(new RunReader(runs[r], bufferBytes));
+        if (readers[r]->next()) heads.push(r);
+    }
+    while (!heads.empty()) {
+        size_t r = heads.top();
+        heads.pop();
+        sink(readers[r]->key, readers[r]->line);
+        if (readers[r]->next()) heads.push(r);
+    }
+    readers.clear();
+    for (const string& run : runs) remove(run.c_str());
+    return true;
+}
+
+// Function to list a file-backed inventory in alphabetical order. The file
+// is cut into chunks that fit the memory cap; each chunk is sorted and
+// spilled as a run on a worker thread while the next one is read, and the
+// runs are merged straight into the table output. An inventory that fits
+// in one chunk is sorted in memory without spilling.
+void listItemsExternal(const InventoryStore& store, const string& filename) {
+    MappedFile file(filename);
+
+    // One chunk being filled plus one per worker may be in memory at once
+    size_t workers = max(1u, thread::hardware_concurrency());
+    size_t chunkBytes = max<size_t>(store.sortMemory / (workers + 1), 64 * 1024);
+    vector<unique_ptr<SortJob>> jobs;
+    size_t joined = 0;
+
+    auto finishJob = [&]() {
+        jobs[joined++]->worker.join();
+    };
+
+    unique_ptr<SortJob> chunk(new SortJob);
+    size_t chunkUsed = 0;
+
+    auto spillChunk = [&]() {
+        if (jobs.size() - joined == workers) finishJob();
+        chunk->filename = filename + ".run" + to_string(jobs.size());
+        SortJob* job = chunk.get();
+        job->worker = thread([job]() { job->run(); });
+        jobs.push_back(move(chunk));
+        chunk.reset(new SortJob);
+        chunkUsed = 0;
+    };
+
+    scanRows(store, file, [&](const RowView& row) {
+        chunk->records.push_back({makeCollationKey(string(row.name)), row.line});
+        chunkUsed += sizeof(SortRecord) + chunk->records.back().key.folded.capacity();
+        if (chunkUsed >= chunkBytes) spillChunk();
     });
+    if (!jobs.empty() && !chunk->records.empty()) spillChunk();
+    while (joined < jobs.size()) finishJob();
 
-    // Display items in formatted table
-    cout << "\n| Item ID\t| Item Name\t\t| Quantity\t| Reg Date\t|\n";
-    cout << "|-----------|-----------------------|-----------|------------------|\n";
-    
-    for (const auto& item : items) {
-        cout << "| " << setw(10) << item.id << "\t| " 
-             << setw(20) << item.name << "\t| " 
-             << setw(10) << item.quantity << "\t| " 
-             << setw(10) << item.registration_date << "\t|\n";
+    printTableHeader();
+    if (jobs.empty()) {
+        stable_sort(chunk->records.begin(), chunk->records.end(),
+                    [](const SortRecord& a, const SortRecord& b) { return a.key < b.key; });
+        for (const SortRecord& record : chunk->records) printCsvRow(record.line);
+    } else {
+        vector<string> runs;
+        bool ok = true;
+        for (const auto& job : jobs) {
+            runs.push_back(job->filename);
+            ok = ok && job->ok;
+        }
+        ok = ok && mergeRuns(runs, store.sortMemory, [](const CollationKey&, string_view line) {
+            printCsvRow(line);
+        });
+        if (!ok) {
+            for (const string& run : runs) remove(run.c_str());
+            cout << "Error writing sort runs next to " << filename << "!\n";
+        }
     }
     cout << "\n";
 }
 
+// Columnar store
+
+// inventory.col holds the live rows sorted by registration date, one
+// column at a time:
+//   ColumnHeader
+//   ZoneMap[blockCount]          one per BLOCK_ROWS rows
+//   int32 dates[rows]            YYYYMMDD, 0 when the date does not parse
+//   int32 quantities[rows]
+// The file is mapped and the columns are used in place. It is derived
+// data: inventory.csv stays the source of truth. The header records the
+// CSV's size, modification time and hash; a query compares only size and
+// time, and reads the CSV to check the hash only when the time is too
+// close to when the stamp was taken to tell an edit apart (see
+// columnStoreCurrent).
+const uint32_t BLOCK_ROWS = 4096;
+const char COLUMN_MAGIC[8] = {'I', 'N', 'V', 'C', 'O', 'L', '3', '\0'};
+
+// How far apart two modification times must be to prove an edit; coarse
+// kernel clocks tick every few milliseconds even with nanosecond fields
+#if defined(_WIN32) || defined(__APPLE__)
+const int64_t MTIME_GRANULARITY_NS = 1000000000;
+#else
+const int64_t MTIME_GRANULARITY_NS = 20000000;
+#endif
+
+// Identifies the inventory.csv a column store was built from
+struct SourceStamp {
+    uint64_t bytes;
+    int64_t modified;           // Nanoseconds since the epoch
+    uint64_t hash;              // FNV-1a of the contents
+};
+
+struct ColumnHeader {
+    char magic[8];              // COLUMN_MAGIC
+    SourceStamp source;
+    int64_t checkedAt;          // When source was last confirmed, same clock as modified
+    uint64_t rows;
+    uint32_t blockCount;
+    uint32_t reserved;
+};
+
+struct ZoneMap {
+    int32_t minDate;
+    int32_t maxDate;
+    int32_t minQuantity;
+    int32_t maxQuantity;
+    int64_t sumQuantity;
+};
+
+// Function to encode YYYY-MM-DD as the integer YYYYMMDD (0 if malformed)
+int32_t encodeDate(string_view date) {
+    if (date.size() != 10 || date[4] != '-' || date[7] != '-') return 0;
+    int32_t value = 0;
+    for (size_t i = 0; i < 10; i++) {
+        if (i == 4 || i == 7) continue;
+        if (date[i] < '0' || date[i] > '9') return 0;
+        value = value * 10 + (date[i] - '0');
+    }
+    int32_t month = value / 100 % 100, day = value % 100;
+    return month >= 1 && month <= 12 && day >= 1 && day <= 31 ? value : 0;
+}
+
+// Function to get the current time on the clock file times use
+int64_t wallClockNanos() {
+    return (int64_t)chrono::duration_cast<chrono::nanoseconds>(
+        chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Function to get the size and modification time of inventory.csv (zero
+// if it does not exist); the hash is left for sourceHash
+SourceStamp sourceStamp() {
+    SourceStamp stamp = {0, 0, 0};
+    struct stat info;
+    if (stat(INVENTORY_FILE.c_str(), &info) != 0) return stamp;
+    stamp.bytes = (uint64_t)info.st_size;
+#if defined(_WIN32) || defined(__APPLE__)
+    stamp.modified = (int64_t)info.st_mtime * 1000000000;
+#else
+    stamp.modified = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    return stamp;
+}
+
+// Function to hash the contents of inventory.csv (reads the whole file)
+uint64_t sourceHash() {
+    MappedFile file(INVENTORY_FILE);
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < file.size(); i++) {
+        hash = (hash ^ (unsigned char)file.data()[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Function to rebuild inventory.col from the live rows of the inventory
+bool buildColumnStore(const InventoryStore& store) {
+    vector<int32_t> dates, quantities;
+
+    int64_t checkedAt = wallClockNanos();
+    SourceStamp source = sourceStamp();
+    source.hash = sourceHash();
+    MappedFile file(store.external ? INVENTORY_FILE : string());    // Empty unless external
+    scanRows(store, file, [&](const RowView& row) {
+        dates.push_back(encodeDate(row.date));
+        quantities.push_back(row.quantity);
+    });
+
+    // Date order makes each block cover a narrow date range
+    vector<uint32_t> order(dates.size());
+    for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return dates[a] < dates[b]; });
+
+    vector<int32_t> sortedDates, sortedQuantities;
+    sortedDates.reserve(order.size());
+    sortedQuantities.reserve(order.size());
+    for (uint32_t i : order) {
+        sortedDates.push_back(dates[i]);
+        sortedQuantities.push_back(quantities[i]);
+    }
+
+    ColumnHeader header = {};
+    memcpy(header.magic, COLUMN_MAGIC, sizeof(header.magic));
+    header.source = source;
+    header.checkedAt = checkedAt;
+    header.rows = order.size();
+    header.blockCount = (uint32_t)((order.size() + BLOCK_ROWS - 1) / BLOCK_ROWS);
+    vector<ZoneMap> zones(header.blockCount);
+    for (uint32_t b = 0; b < header.blockCount; b++) {
+        size_t first = (size_t)b * BLOCK_ROWS, last = min<size_t>(first + BLOCK_ROWS, order.size());
+        ZoneMap& zone = zones[b];
+        zone = {sortedDates[first], sortedDates[last - 1], INT32_MAX, INT32_MIN, 0};
+        for (size_t i = first; i < last; i++) {
+            zone.minQuantity = min(zone.minQuantity, sortedQuantities[i]);
+            zone.maxQuantity = max(zone.maxQuantity, sortedQuantities[i]);
+            zone.sumQuantity += sortedQuantities[i];
+        }
+    }
+
+    // Write to a temporary file and rename it over the old one
+    string tempName = COLUMN_FILE + ".tmp";
+    ofstream out(tempName, ios::binary);
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)zones.data(), zones.size() * sizeof(ZoneMap));
+    out.write((const char*)sortedDates.data(), sortedDates.size() * sizeof(int32_t));
+    out.write((const char*)sortedQuantities.data(), sortedQuantities.size() * sizeof(int32_t));
+    out.close();
+    if (!out) {
+        remove(tempName.c_str());
+        return false;
+    }
+    remove(COLUMN_FILE.c_str());    // rename() does not replace on Windows
+    return rename(tempName.c_str(), COLUMN_FILE.c_str()) == 0;
+}
+
+// Function to check that a mapped inventory.col is complete and was built
+// from the current inventory.csv. appendMark is the writer's byte count
+// when this process last built or confirmed the file (UINT64_MAX if it
+// has not), so our own appends are caught without a stat. Otherwise a
+// size or modification time that differs means the CSV changed. Equal
+// ones prove nothing when the CSV was modified within one clock tick of
+// checkedAt, since a later edit in that tick keeps the same time; only
+// then is the CSV hashed, and checkedAt moved forward once it matches.
+bool columnStoreCurrent(const MappedFile& file, uint64_t appendMark, uint64_t appended) {
+    if (file.size() < sizeof(ColumnHeader)) return false;
+    const ColumnHeader& header = *(const ColumnHeader*)file.data();
+    if (memcmp(header.magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0 ||
+        header.rows > (file.size() - sizeof(ColumnHeader)) / (2 * sizeof(int32_t)) ||
+        header.blockCount != (header.rows + BLOCK_ROWS - 1) / BLOCK_ROWS) {
+        return false;
+    }
+    uint64_t columns = header.blockCount * sizeof(ZoneMap) + header.rows * 2 * sizeof(int32_t);
+    if (file.size() != sizeof(ColumnHeader) + columns) return false;
+    if (appendMark != UINT64_MAX && appendMark != appended) return false;
+
+    SourceStamp current = sourceStamp();
+    if (current.bytes != header.source.bytes || current.modified != header.source.modified) {
+        return false;
+    }
+    if (header.checkedAt - current.modified >= MTIME_GRANULARITY_NS) return true;
+
+    int64_t checkedAt = wallClockNanos();
+    if (sourceHash() != header.source.hash) return false;
+    fstream out(COLUMN_FILE, ios::binary | ios::in | ios::out);
+    out.seekp(offsetof(ColumnHeader, checkedAt));
+    out.write((const char*)&checkedAt, sizeof(checkedAt));
+    return true;
+}
+
+// Function to total the quantities of items registered between from and
+// to (YYYYMMDD, inclusive). Blocks outside the range are skipped and
+// blocks inside it are answered from their zone map; only the blocks at
+// the edges are scanned, with a branch-free count/sum loop that the
+// compiler vectorizes (at -O3). Items without a valid date never match.
+void sumItems(InventoryStore& store, const InventoryWriter& writer, int32_t from, int32_t to) {
+    bool rebuilt = false;
+    uint64_t appended = writer.appendedBytes();
+    unique_ptr<MappedFile> file(new MappedFile(COLUMN_FILE));
+    if (!columnStoreCurrent(*file, store.columnAppendMark, appended)) {
+        file.reset();
+        if (!buildColumnStore(store)) {
+            cout << "Error writing " << COLUMN_FILE << "!\n";
+            return;
+        }
+        file.reset(new MappedFile(COLUMN_FILE));
+        rebuilt = true;
+    }
+    store.columnAppendMark = appended;
+
+    const ColumnHeader& header = *(const ColumnHeader*)file->data();
+    const ZoneMap* zones = (const ZoneMap*)(file->data() + sizeof(ColumnHeader));
+    const int32_t* dates = (const int32_t*)(zones + header.blockCount);
+    const int32_t* quantities = dates + header.rows;
+
+    uint64_t count = 0;
+    int64_t sum = 0;
+    int32_t minQuantity = INT32_MAX, maxQuantity = INT32_MIN;
+    size_t skipped = 0, fromZones = 0, scanned = 0;
+
+    for (uint32_t b = 0; b < header.blockCount; b++) {
+        const ZoneMap& zone = zones[b];
+        size_t first = (size_t)b * BLOCK_ROWS, last = min<size_t>(first + BLOCK_ROWS, header.rows);
+        if (zone.maxDate < from || zone.minDate > to) {
+            skipped++;
+        } else if (zone.minDate >= from && zone.maxDate <= to) {
+            fromZones++;
+            count += last - first;
+            sum += zone.sumQuantity;
+            minQuantity = min(minQuantity, zone.minQuantity);
+            maxQuantity = max(maxQuantity, zone.maxQuantity);
+        } else {
+            scanned++;
+            int64_t blockSum = 0;
+            int32_t blockCount = 0;
+            for (size_t i = first; i < last; i++) {
+                int32_t inRange = (dates[i] >= from) & (dates[i] <= to);
+                blockCount += inRange;
+                blockSum += quantities[i] & -inRange;
+            }
+            count += blockCount;
+            sum += blockSum;
+
+            // SSE2 has no 32-bit min/max, so this pass stays scalar
+            for (size_t i = first; i < last; i++) {
+                if (dates[i] < from || dates[i] > to) continue;
+                minQuantity = min(minQuantity, quantities[i]);
+                maxQuantity = max(maxQuantity, quantities[i]);
+            }
+        }
+    }
+
+    if (rebuilt) cout << "Rebuilt " << COLUMN_FILE << " (" << header.rows << " items)\n";
+    cout << "Items: " << count << "\n";
+    cout << "Total quantity: " << sum << "\n";
+    if (count > 0) cout << "Min / max quantity: " << minQuantity << " / " << maxQuantity << "\n";
+    cout << "Blocks: " << skipped << " skipped, " << fromZones << " from zone maps, "
+         << scanned << " scanned\n";
+}
+
+// Function to time the old itemslist sort (both names folded in every
+// comparison: toLower, or the locale's rules with --locale) against
+// sorting on precomputed collation keys
+void benchmarkSort(size_t rows) {
+    static const char* syllables[] = {"ban", "App", "le", "Or", "an", "ge", "MAN", "go",
+                                      "pe", "Ar", "ch", "ER", "ry", "ki", "WI", "lem"};
+    mt19937 rng(42);
+    vector<string> names(rows);
+    for (auto& name : names) {
+        size_t parts = 2 + rng() % 7;
+        for (size_t p = 0; p < parts; p++) name += syllables[rng() % 16];
+    }
+    cout << "Sorting " << rows << " names\n";
+
+    auto elapsedMs = [](chrono::steady_clock::time_point start) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+
+    vector<string> plain = names;
+    auto start = chrono::steady_clock::now();
+    if (localeCollation) {
+        const collate<char>& rules = use_facet<collate<char>>(locale());
+        sort(plain.begin(), plain.end(), [&](const string& a, const string& b) {
+            string x = toLower(a), y = toLower(b);
+            return rules.compare(x.data(), x.data() + x.size(), y.data(), y.data() + y.size()) < 0;
+        });
+    } else {
+        sort(plain.begin(), plain.end(), [](const string& a, const string& b) {
+            return toLower(a) < toLower(b);
+        });
+    }
+    double plainMs = elapsedMs(start);
+    cout << "  folding in comparator: " << fixed << setprecision(1) << plainMs << " ms\n";
+
+    start = chrono::steady_clock::now();
+    vector<pair<CollationKey, size_t>> keys;
+    keys.reserve(rows);
+    for (size_t i = 0; i < rows; i++) keys.emplace_back(makeCollationKey(names[i]), i);
+    double keyMs = elapsedMs(start);
+    sort(keys.begin(), keys.end());
+    double keyedMs = elapsedMs(start);
+    cout << "  collation keys:        " << keyedMs << " ms (" << keyMs << " ms building keys)\n";
+    cout << "  speedup:               " << plainMs / keyedMs << "x\n";
+
+    // Both orders must agree on the folded names (folded the way the keys are)
+    for (size_t i = 0; i < rows; i++) {
+        if (foldName(plain[i]) != keys[i].first.folded) {
+            cout << "  orders differ at row " << i << "!\n";
+            return;
+        }
+    }
+    cout << "  orders match\n" << defaultfloat;
+}
+
 // Function to display help information
 void showHelp() {
     cout << "\nCommands syntaxes:\n";
     cout << "itemadd <item_id> <item_name> <quantity> <registration_date>\n";
     cout << "itemslist\n";
+    cout << "itemslist --limit <count> [--offset <start>]\n";
+    cout << "itemslist --top <count> --by quantity\n";
+    cout << "itemsum [--from <YYYY-MM-DD>] [--to <YYYY-MM-DD>]\n";
+    cout << "sync\n";
     cout << "help\n";
     cout << "exit\n\n";
 }
 
 // Function to process user commands
-void processCommand(const string& command) {
+void processCommand(InventoryStore& store, InventoryWriter& writer, const string& command) {
     string cmd = toLower(command);
+    if (!writer.flushIfDue()) {
+        cout << "Error: could not write buffered item(s) to file; will retry.\n";
+    }
     
     if (cmd == "help") {
         showHelp();
     }
     else if (cmd == "itemslist") {
-        listItems();
+        if (store.external) {
+            writer.flush();
+            listItemsExternal(store, INVENTORY_FILE);
+        } else {
+            listItems(store);
+        }
+    }
+    else if (cmd.substr(0, 10) == "itemslist ") {
+        stringstream ss(cmd.substr(10));
+        string option, value;
+        map<string, string> options;
+        bool valid = true;
+        while (ss >> option) {
+            if (!(ss >> value) || !options.emplace(option, value).second) valid = false;
+        }
+
+        // Counts are plain non-negative numbers
+        auto count = [&](const string& name, size_t& result) {
+            int parsed;
+            if (!options.count(name)) return true;
+            if (!parseQuantity(options[name], parsed) || parsed < 0) return false;
+            result = (size_t)parsed;
+            return true;
+        };
+        size_t limit = SIZE_MAX, offset = 0, top = SIZE_MAX;
+        valid = valid && count("--limit", limit) && count("--offset", offset) && count("--top", top);
+        for (const auto& entry : options) {
+            valid = valid && (entry.first == "--limit" || entry.first == "--offset" ||
+                              entry.first == "--top" || entry.first == "--by");
+        }
+        bool topMode = options.count("--top") || options.count("--by");
+
+        if (valid && topMode && options.size() == 2 && top != SIZE_MAX &&
+            options.count("--by") && options["--by"] == "quantity") {
+            writer.flush();
+            listTopItems(store, top);
+        } else if (valid && !topMode && limit != SIZE_MAX) {
+            writer.flush();
+            listItemsPage(store, offset, limit);
+        } else {
+            cout << "Invalid itemslist command format!\n";
+        }
+    }
+    else if (cmd == "itemsum" || cmd.substr(0, 8) == "itemsum ") {
+        stringstream ss(cmd.substr(7));
+        string option, value;
+        int32_t from = 1, to = INT32_MAX;
+        bool valid = true;
+        while (valid && ss >> option) {
+            valid = (option == "--from" || option == "--to") && ss >> value && encodeDate(value) != 0;
+            if (valid) (option == "--from" ? from : to) = encodeDate(value);
+        }
+
+        if (valid) {
+            writer.flush();
+            sumItems(store, writer, from, to);
+        } else {
+            cout << "Invalid itemsum command format! Dates are YYYY-MM-DD.\n";
+        }
+    }
+    else if (cmd == "sync") {
+        if (writer.sync()) {
+            cout << "Inventory saved to disk.\n";
+        } else {
+            cout << "Error writing to file!\n";
+        }
     }
     else if (cmd == "exit") {
         cout << "Exiting program...\n";
+        writer.close();
         exit(0);
     }
     else if (cmd.substr(0, 8) == "itemadd ") {
@@ -117,7 +1367,7 @@ void processCommand(const string& command) {
         if (ss >> id >> name >> quantity_str >> date) {
             try {
                 int quantity = stoi(quantity_str);
-                addItem(id, name, quantity, date);
+                addItem(store, writer, id, name, quantity, date);
             } catch (...) {
                 cout << "Invalid quantity format!\n";
             }
@@ -130,15 +1380,66 @@ void processCommand(const string& command) {
     }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    WriterOptions writerOptions;
+    size_t sortMemoryMb = 0;
+    auto usage = [](const string& error) {
+        if (!error.empty()) cout << "Error: " << error << "\n";
+        cout << "Usage: inventory_system [--sync none|batch|always] [--flush-rows N]"
+             << " [--flush-ms N] [--sort-memory MB] [--locale] [--bench-sort ROWS]\n";
+        return 1;
+    };
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        string value = (i + 1 < argc) ? argv[i + 1] : "";
+        unsigned long long number = 0;
+        bool numeric = parseCount(value, number);
+        if (arg == "--sync" && (value == "none" || value == "batch" || value == "always")) {
+            writerOptions.syncPolicy = value == "none" ? SyncPolicy::None
+                                     : value == "batch" ? SyncPolicy::Batch : SyncPolicy::Always;
+            i++;
+        } else if (arg == "--flush-rows") {
+            if (!numeric || number == 0) return usage("--flush-rows needs a whole number of at least 1");
+            writerOptions.maxRows = number;
+            i++;
+        } else if (arg == "--flush-ms") {
+            if (!numeric || number > (unsigned long long)INT64_MAX) return usage("--flush-ms needs a whole number");
+            writerOptions.maxDelayMs = (long long)number;
+            i++;
+        } else if (arg == "--sort-memory") {
+            if (!numeric || number > SIZE_MAX / (1024 * 1024)) return usage("--sort-memory needs a size in MB");
+            sortMemoryMb = number;
+            i++;
+        } else if (arg == "--locale") {
+            locale::global(locale(""));
+            localeCollation = true;
+        } else if (arg == "--bench-sort") {
+            if (!numeric || number == 0) return usage("--bench-sort needs a row count of at least 1");
+            benchmarkSort(number);
+            return 0;
+        } else {
+            return usage("");
+        }
+    }
+
+    InventoryStore store;
+    store.external = sortMemoryMb > 0;
+    store.sortMemory = sortMemoryMb * 1024 * 1024;
+    loadInventory(store, INVENTORY_FILE);
+    InventoryWriter writer(writerOptions);
+    if (!writer.open(INVENTORY_FILE)) {
+        cout << "Error opening file!\n";
+        return 1;
+    }
+
     cout << "Welcome to RCA Inventory System\n";
     cout << "Type 'help' for available commands\n\n";
 
     string command;
     while (true) {
         cout << "> ";
-        getline(cin, command);
-        processCommand(command);
+        if (!getline(cin, command)) break;     // End of a piped script
+        processCommand(store, writer, command);
     }
 
     return 0;
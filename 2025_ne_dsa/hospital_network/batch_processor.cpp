@@ -0,0 +1,358 @@
+#include "batch_processor.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
+
+using namespace std;
+
+static string trim(const string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+static bool parseInteger(const string& text, long long& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    errno = 0;
+    value = strtoll(text.c_str(), &end, 10);
+    return *end == '\0' && errno != ERANGE;
+}
+
+// An integer in [minimum, INT_MAX]; larger values would wrap in the
+// network's int fields
+static bool parseInt(const string& text, int minimum, int& value) {
+    long long parsed;
+    if (!parseInteger(text, parsed) || parsed < minimum ||
+        parsed > numeric_limits<int>::max()) {
+        return false;
+    }
+    value = (int)parsed;
+    return true;
+}
+
+static bool parseNumber(const string& text, double& value) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = strtod(text.c_str(), &end);
+    return *end == '\0';
+}
+
+BatchProcessor::BatchProcessor(HospitalNetwork& network, ostream& out,
+                               const BatchOptions& options)
+    : network(network), out(out), options(options) {
+    if (this->options.transactionSize == 0) this->options.transactionSize = 1;
+}
+
+// Restores the caller's journal sync policy when run() returns or throws
+class SyncPolicyGuard {
+public:
+    explicit SyncPolicyGuard(HospitalNetwork& network)
+        : network(network), saved(network.getJournalSyncPolicy()) {}
+    ~SyncPolicyGuard() { network.setJournalSyncPolicy(saved); }
+
+    SyncPolicyGuard(const SyncPolicyGuard&) = delete;
+    SyncPolicyGuard& operator=(const SyncPolicyGuard&) = delete;
+
+    const JournalSyncPolicy& previous() const { return saved; }
+
+private:
+    HospitalNetwork& network;
+    JournalSyncPolicy saved;
+};
+
+BatchSummary BatchProcessor::run(istream& in) {
+    auto start = chrono::steady_clock::now();
+    summary = BatchSummary();
+
+    // Records are fsynced per transaction rather than per 64 changes
+    SyncPolicyGuard restorePolicy(network);
+    JournalSyncPolicy policy = restorePolicy.previous();
+    policy.maxPendingRecords = max(policy.maxPendingRecords, options.transactionSize);
+    policy.maxDelayMs = max(policy.maxDelayMs, 60 * 1000LL);
+    network.setJournalSyncPolicy(policy);
+
+    string text;
+    size_t line = 0;
+    while (getline(in, text)) {
+        line++;
+        string command = trim(text);
+        if (command.empty() || command[0] == '#') continue;
+
+        summary.commands++;
+        execute(splitCommand(command), line);
+    }
+    if (transactionOpen) commitTransaction();
+
+    summary.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    out << "Processed " << summary.commands << " commands: "
+        << summary.mutations << " changes in " << summary.transactions << " transactions, "
+        << summary.queries << " queries, " << summary.checkpoints << " checkpoints, "
+        << summary.errors << " errors (" << summary.elapsedMs << " ms)\n";
+    out.flush();
+    return summary;
+}
+
+vector<string> BatchProcessor::splitCommand(const string& text) {
+    vector<string> fields;
+    stringstream ss(text);
+    string field;
+    while (getline(ss, field, ',')) {
+        fields.push_back(trim(field));
+    }
+    if (!text.empty() && text.back() == ',') fields.push_back("");
+    return fields;
+}
+
+// Command dispatch
+void BatchProcessor::execute(const vector<string>& fields, size_t line) {
+    string verb = fields[0];
+    transform(verb.begin(), verb.end(), verb.begin(), ::tolower);
+    size_t arguments = fields.size() - 1;
+
+    if (verb == "add" || verb == "update") {
+        int patients;
+        if (arguments != 4 || !parseInt(fields[4], numeric_limits<int>::min(), patients)) {
+            reportError(line, verb + " expects ID,Name,Location,PatientCount (PatientCount fits an int)");
+            return;
+        }
+        bool adding = (verb == "add");
+        mutate(line, [&]() {
+            return adding ? network.addHospital(fields[1], fields[2], fields[3], patients)
+                          : network.updateHospital(fields[1], fields[2], fields[3], patients);
+        });
+    } else if (verb == "delete") {
+        if (arguments == 0) {
+            reportError(line, "delete expects at least one hospital ID");
+            return;
+        }
+        vector<string> ids(fields.begin() + 1, fields.end());
+        size_t distinct = set<string>(ids.begin(), ids.end()).size();
+        mutate(line, [&]() {
+            return ids.size() == 1 ? network.deleteHospital(ids[0])
+                                   : network.deleteHospitals(ids) == distinct;
+        });
+    } else if (verb == "connect") {
+        double distance = 0.0;
+        if ((arguments != 3 && arguments != 4) ||
+            (arguments == 4 && !parseNumber(fields[4], distance))) {
+            reportError(line, "connect expects ID1,ID2,Description[,Distance]");
+            return;
+        }
+        mutate(line, [&]() {
+            return network.addConnection(fields[1], fields[2], fields[3], distance);
+        });
+    } else if (verb == "disconnect") {
+        if (arguments != 2) {
+            reportError(line, "disconnect expects ID1,ID2");
+            return;
+        }
+        mutate(line, [&]() { return network.removeConnection(fields[1], fields[2]); });
+    } else if (verb == "shortest" || verb == "longest") {
+        query(verb == "longest", fields, line);
+    } else if (verb == "nearest") {
+        nearest(fields, line);
+    } else if (verb == "connected") {
+        connected(fields, line);
+    } else if (verb == "hierarchy") {
+        if (explicitTransaction) {
+            reportError(line, "hierarchy is not allowed inside begin/commit");
+            return;
+        }
+        buildHierarchy(line);
+    } else if (verb == "begin") {
+        if (explicitTransaction) {
+            reportError(line, "transaction already open");
+            return;
+        }
+        if (transactionOpen) commitTransaction();
+        openTransaction();
+        explicitTransaction = true;
+    } else if (verb == "commit") {
+        if (!explicitTransaction) {
+            reportError(line, "commit without begin");
+            return;
+        }
+        commitTransaction();
+        checkpointIfDue();
+    } else if (verb == "checkpoint") {
+        if (explicitTransaction) {
+            reportError(line, "checkpoint is not allowed inside begin/commit");
+            return;
+        }
+        checkpoint();
+    } else {
+        reportError(line, "unknown command '" + fields[0] + "'");
+    }
+}
+
+// Runs one change with the network's messages captured; they are shown
+// only when the change fails (or always with echo on)
+void BatchProcessor::mutate(size_t line, const function<bool()>& change) {
+    if (!transactionOpen) openTransaction();
+
+    stringstream messages;
+    streambuf* console = cout.rdbuf(messages.rdbuf());
+    bool ok = change();
+    cout.rdbuf(console);
+
+    if (!ok) {
+        string message;
+        getline(messages, message);
+        reportError(line, message.empty() ? "change rejected" : message);
+        return;
+    }
+    if (options.echo) out << messages.str();
+
+    summary.mutations++;
+    pendingMutations++;
+    sinceCheckpoint++;
+    if (!explicitTransaction) {
+        if (pendingMutations >= options.transactionSize) commitTransaction();
+        checkpointIfDue();
+    }
+}
+
+void BatchProcessor::query(bool longest, const vector<string>& fields, size_t line) {
+    long long budgetMs = DEFAULT_LONGEST_PATH_BUDGET_MS;
+    if (fields.size() != 3 &&
+        !(longest && fields.size() == 4 && parseInteger(fields[3], budgetMs) && budgetMs > 0)) {
+        reportError(line, longest ? "longest expects ID1,ID2[,BudgetMs]" : "shortest expects ID1,ID2");
+        return;
+    }
+
+    // Outside an explicit transaction, queries see every earlier command
+    if (transactionOpen && !explicitTransaction) commitTransaction();
+    summary.queries++;
+
+    shared_ptr<const NetworkView> snapshot = network.view();
+    const string& start = fields[1];
+    const string& end = fields[2];
+    bool complete = true;
+    vector<string> path;
+    if (longest) {
+        SearchBudget budget;
+        budget.timeLimitMs = budgetMs;
+        path = snapshot->longestPath(start, end, budget, complete);
+    } else {
+        path = snapshot->shortestPath(start, end);
+    }
+
+    out << (longest ? "longest " : "shortest ") << start << " " << end << ": ";
+    if (path.empty()) {
+        out << "no path";
+    } else {
+        for (size_t i = 0; i < path.size(); i++) {
+            out << (i ? " -> " : "") << path[i];
+        }
+        out << " (" << snapshot->pathDistance(path) << ")";
+    }
+    out << (complete ? "\n" : " [budget reached]\n");
+}
+
+void BatchProcessor::nearest(const vector<string>& fields, size_t line) {
+    int k, threshold;
+    if (fields.size() != 4 || !parseInt(fields[2], 1, k) ||
+        !parseInt(fields[3], numeric_limits<int>::min(), threshold)) {
+        reportError(line, "nearest expects ID,K,Threshold (K at least 1, both fit an int)");
+        return;
+    }
+
+    if (transactionOpen && !explicitTransaction) commitTransaction();
+    summary.queries++;
+
+    vector<NearbyHospital> nearby = network.view()->nearestWithCapacity(fields[1], k, threshold);
+    out << "nearest " << fields[1] << " <" << threshold << ":";
+    if (nearby.empty()) out << " none";
+    for (const auto& hospital : nearby) {
+        out << " " << hospital.id << "(" << hospital.distance << ", "
+            << hospital.patientCount << ")";
+    }
+    out << "\n";
+}
+
+void BatchProcessor::connected(const vector<string>& fields, size_t line) {
+    if (fields.size() != 3) {
+        reportError(line, "connected expects ID1,ID2");
+        return;
+    }
+
+    if (transactionOpen && !explicitTransaction) commitTransaction();
+    summary.queries++;
+
+    shared_ptr<const NetworkView> snapshot = network.view();
+    out << "connected " << fields[1] << " " << fields[2] << ": "
+        << (snapshot->connected(fields[1], fields[2]) ? "yes" : "no")
+        << " (" << snapshot->componentCount() << " groups)\n";
+}
+
+// Rebuilding the hierarchy publishes a new view, so it commits first
+void BatchProcessor::buildHierarchy(size_t line) {
+    if (transactionOpen) commitTransaction();
+
+    stringstream messages;
+    streambuf* console = cout.rdbuf(messages.rdbuf());
+    bool built = network.buildContractionHierarchy();
+    cout.rdbuf(console);
+
+    string message;
+    getline(messages, message);
+    if (!built) {
+        reportError(line, message);
+        return;
+    }
+    out << message << "\n";
+}
+
+// Transactions
+void BatchProcessor::openTransaction() {
+    network.beginBatch();
+    transactionOpen = true;
+    pendingMutations = 0;
+}
+
+void BatchProcessor::commitTransaction() {
+    network.commitBatch();
+    network.syncJournal();
+    transactionOpen = false;
+    explicitTransaction = false;
+    if (pendingMutations > 0) summary.transactions++;
+    pendingMutations = 0;
+}
+
+// Automatic checkpoints wait for an explicit transaction to commit, so
+// begin/commit is never split into two transactions
+void BatchProcessor::checkpointIfDue() {
+    if (options.checkpointEvery > 0 && sinceCheckpoint >= options.checkpointEvery) {
+        checkpoint();
+    }
+}
+
+// A checkpoint also commits the open (automatic) transaction
+void BatchProcessor::checkpoint() {
+    if (transactionOpen) commitTransaction();
+
+    stringstream messages;
+    streambuf* console = cout.rdbuf(messages.rdbuf());
+    bool saved = network.saveData();
+    cout.rdbuf(console);
+
+    if (!saved) {
+        reportError(0, "checkpoint could not save the network");
+        return;
+    }
+    summary.checkpoints++;
+    sinceCheckpoint = 0;
+}
+
+void BatchProcessor::reportError(size_t line, const string& message) {
+    summary.errors++;
+    if (line > 0) out << "line " << line << ": ";
+    out << message << "\n";
+}
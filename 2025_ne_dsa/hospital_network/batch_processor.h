@@ -0,0 +1,95 @@
+/**
+ * Batch Processor Header
+ *
+ * Runs a stream of text commands against a HospitalNetwork without the
+ * interactive menu. One command per line, fields separated by commas:
+ *
+ *   add,H1,City Hospital,Kigali,120        update,H1,Name,Location,90
+ *   delete,H1[,H2,...]                     connect,H1,H2,Description[,distance]
+ *   disconnect,H1,H2                       shortest,H1,H2
+ *   longest,H1,H2[,budget ms]              nearest,H1,K,Threshold
+ *   connected,H1,H2                        hierarchy
+ *   begin / commit / checkpoint
+ *
+ * Blank lines and lines starting with '#' are skipped.
+ *
+ * Mutations are grouped into transactions: the read view is published at
+ * most once and the journal fsynced once per transaction instead of once
+ * per change.
+ * Transactions close automatically every transactionSize mutations and
+ * before a query, so queries see every earlier command. begin/commit mark
+ * one explicitly; queries inside it see the state before `begin`, and
+ * hierarchy and checkpoint (which commit) are rejected inside it.
+ * Automatic checkpoints wait until it commits.
+ * A failed command is reported and skipped; earlier changes in the same
+ * transaction are kept, since the network has no rollback.
+ *
+ * The full save (CSV files and snapshot) waits for a checkpoint or for
+ * the network to be destroyed. Query results, errors and the summary are
+ * written to the given output stream; the network's own per-change
+ * messages are captured and only shown when they report an error.
+ */
+
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include "hospital_network.h"
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct BatchOptions {
+    size_t transactionSize = 1000;      // Mutations per automatic transaction
+    size_t checkpointEvery = 0;         // Full save every N mutations (0 = at exit)
+    bool echo = false;                  // Also show the network's success messages
+};
+
+struct BatchSummary {
+    size_t commands = 0;
+    size_t mutations = 0;
+    size_t queries = 0;
+    size_t transactions = 0;
+    size_t checkpoints = 0;
+    size_t errors = 0;
+    double elapsedMs = 0;
+};
+
+class BatchProcessor {
+public:
+    BatchProcessor(HospitalNetwork& network, ostream& out,
+                   const BatchOptions& options = BatchOptions());
+
+    BatchSummary run(istream& in);
+
+private:
+    HospitalNetwork& network;
+    ostream& out;
+    BatchOptions options;
+    BatchSummary summary;
+
+    bool transactionOpen = false;
+    bool explicitTransaction = false;
+    size_t pendingMutations = 0;        // In the open transaction
+    size_t sinceCheckpoint = 0;
+
+    void execute(const vector<string>& fields, size_t line);
+    void mutate(size_t line, const function<bool()>& change);
+    void query(bool longest, const vector<string>& fields, size_t line);
+    void nearest(const vector<string>& fields, size_t line);
+    void connected(const vector<string>& fields, size_t line);
+    void buildHierarchy(size_t line);
+
+    void openTransaction();
+    void commitTransaction();
+    void checkpoint();
+    void checkpointIfDue();
+
+    void reportError(size_t line, const string& message);
+    static vector<string> splitCommand(const string& text);
+};
+
+#endif // BATCH_PROCESSOR_H
@@ -0,0 +1,376 @@
+/**
+ * @file network_benchmark.cpp
+ * @brief Benchmark for HospitalNetwork on synthetic networks
+ *
+ * @details Generates a seeded network (random geometric, grid or scale-free),
+ * times the main HospitalNetwork operations and prints p50/p99 latencies
+ * and peak RSS as JSON, so runs can be compared to catch regressions.
+ *
+ * Build together with every module source except main.cpp, e.g. from the
+ * hospital_network directory:
+ *   g++ -std=c++17 -O2 -pthread -I. bench/network_benchmark.cpp \
+ *       bulk_loader.cpp distance_matrix.cpp hospital.cpp ... -o network_benchmark
+ *
+ * Usage:
+ *   network_benchmark [--topology geometric|grid|scalefree] [--hospitals N]
+ *                     [--edges M] [--seed S] [--queries Q] [--longest-queries L]
+ *                     [--longest-budget-ms T] [--deletes D] [--repeats R]
+ *                     [--dir PATH] [--output FILE]
+ *
+ * The network's data files are written to a new scratch directory created
+ * inside --dir (default: the system temporary directory). Only that
+ * scratch directory is removed afterwards; nothing else in --dir is touched.
+ */
+
+#include "../hospital_network.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+
+struct BenchmarkOptions {
+    string topology = "geometric";
+    int hospitals = 10000;
+    long long edges = 30000;        // Target count; a grid always has its own
+    unsigned seed = 1;
+    int queries = 200;
+    int longestQueries = 20;
+    long long longestBudgetMs = 50;
+    int deletes = 100;
+    int repeats = 3;
+    string dir;                     // Parent of the scratch directory (empty = temp)
+    string output;                  // Empty = stdout
+};
+
+struct SyntheticEdge {
+    int from;
+    int to;
+    double distance;
+};
+
+// Discards everything; HospitalNetwork reports every change on cout
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
+// Network generators
+static vector<SyntheticEdge> generateGeometric(int n, long long edges, mt19937& rng) {
+    // Expected edges for radius r: n^2 / 2 * pi * r^2
+    double radius = sqrt(2.0 * edges / (M_PI * (double)n * n));
+    uniform_real_distribution<double> unit(0.0, 1.0);
+    vector<double> x(n), y(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = unit(rng);
+        y[i] = unit(rng);
+    }
+
+    // Bucket points into cells of side radius so only neighbouring
+    // cells are compared
+    int cells = max(1, min(4096, (int)(1.0 / max(radius, 1e-9))));
+    vector<vector<int>> grid((size_t)cells * cells);
+    auto cellOf = [&](double v) { return min(cells - 1, (int)(v * cells)); };
+    for (int i = 0; i < n; i++) {
+        grid[(size_t)cellOf(y[i]) * cells + cellOf(x[i])].push_back(i);
+    }
+
+    vector<SyntheticEdge> result;
+    for (int i = 0; i < n; i++) {
+        int cx = cellOf(x[i]), cy = cellOf(y[i]);
+        for (int gy = max(0, cy - 1); gy <= min(cells - 1, cy + 1); gy++) {
+            for (int gx = max(0, cx - 1); gx <= min(cells - 1, cx + 1); gx++) {
+                for (int j : grid[(size_t)gy * cells + gx]) {
+                    if (j <= i) continue;
+                    double d = hypot(x[i] - x[j], y[i] - y[j]);
+                    if (d <= radius) result.push_back({i, j, round(d * 1000.0) + 1});
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static vector<SyntheticEdge> generateGrid(int n, mt19937& rng) {
+    int side = max(1, (int)ceil(sqrt((double)n)));
+    uniform_int_distribution<int> weight(1, 100);
+    vector<SyntheticEdge> result;
+    for (int i = 0; i < n; i++) {
+        if ((i + 1) % side != 0 && i + 1 < n) result.push_back({i, i + 1, (double)weight(rng)});
+        if (i + side < n) result.push_back({i, i + side, (double)weight(rng)});
+    }
+    return result;
+}
+
+// Barabasi-Albert preferential attachment: each new hospital links to
+// edges / n existing ones chosen in proportion to their degree
+static vector<SyntheticEdge> generateScaleFree(int n, long long edges, mt19937& rng) {
+    int perNode = (int)max(1LL, edges / max(1, n));
+    uniform_int_distribution<int> weight(1, 100);
+    vector<int> endpoints;          // Each vertex appears once per connection
+    vector<SyntheticEdge> result;
+
+    for (int v = 1; v < n; v++) {
+        vector<int> chosen;
+        int links = min(perNode, v);
+        for (int attempt = 0; (int)chosen.size() < links && attempt < 16 * links; attempt++) {
+            int u = endpoints.empty() ? (int)(rng() % v) : endpoints[rng() % endpoints.size()];
+            if (std::find(chosen.begin(), chosen.end(), u) == chosen.end()) chosen.push_back(u);
+        }
+        for (int u : chosen) {
+            result.push_back({v, u, (double)weight(rng)});
+            endpoints.push_back(u);
+            endpoints.push_back(v);
+        }
+    }
+    return result;
+}
+
+// Latency statistics
+struct LatencySeries {
+    string name;
+    vector<double> micros;
+};
+
+static double percentile(vector<double> sorted, double p) {
+    if (sorted.empty()) return 0;
+    sort(sorted.begin(), sorted.end());
+    size_t rank = (size_t)ceil(p / 100.0 * sorted.size());
+    return sorted[min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+template <typename Operation>
+static void timeOnce(LatencySeries& series, Operation operation) {
+    auto start = chrono::steady_clock::now();
+    operation();
+    auto stop = chrono::steady_clock::now();
+    series.micros.push_back(chrono::duration<double, micro>(stop - start).count());
+}
+
+static long long peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return (long long)(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;      // Bytes on macOS
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+static string toJson(const BenchmarkOptions& options, size_t connections,
+                     const vector<LatencySeries>& series, int longestIncomplete) {
+    stringstream json;
+    json << fixed << setprecision(2);
+    json << "{\n"
+         << "  \"topology\": \"" << options.topology << "\",\n"
+         << "  \"seed\": " << options.seed << ",\n"
+         << "  \"hospitals\": " << options.hospitals << ",\n"
+         << "  \"connections\": " << connections << ",\n"
+         << "  \"operations\": {\n";
+    for (size_t i = 0; i < series.size(); i++) {
+        const vector<double>& micros = series[i].micros;
+        double total = 0;
+        for (double value : micros) total += value;
+        json << "    \"" << series[i].name << "\": {"
+             << "\"count\": " << micros.size()
+             << ", \"p50_us\": " << percentile(micros, 50)
+             << ", \"p99_us\": " << percentile(micros, 99)
+             << ", \"mean_us\": " << (micros.empty() ? 0 : total / micros.size())
+             << ", \"total_ms\": " << total / 1000.0 << "}"
+             << (i + 1 < series.size() ? ",\n" : "\n");
+    }
+    json << "  },\n"
+         << "  \"longest_path_incomplete\": " << longestIncomplete << ",\n"
+         << "  \"peak_rss_kb\": " << peakRssKb() << "\n"
+         << "}\n";
+    return json.str();
+}
+
+// A directory of our own inside parent, so cleanup can never reach files
+// that were there before the run
+static filesystem::path createScratchDirectory(const filesystem::path& parent) {
+    random_device entropy;
+    filesystem::create_directories(parent);
+    for (int attempt = 0; attempt < 100; attempt++) {
+        filesystem::path candidate = parent / ("network_bench_" + to_string(entropy()));
+        if (filesystem::create_directory(candidate)) return candidate;
+    }
+    throw runtime_error("could not create a scratch directory in " + parent.string());
+}
+
+static bool parseArguments(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (i + 1 >= argc) {
+            cerr << "Error: " << flag << " needs a value.\n";
+            return false;
+        }
+        string value = argv[++i];
+        if (flag == "--topology") options.topology = value;
+        else if (flag == "--hospitals") options.hospitals = stoi(value);
+        else if (flag == "--edges") options.edges = stoll(value);
+        else if (flag == "--seed") options.seed = (unsigned)stoul(value);
+        else if (flag == "--queries") options.queries = stoi(value);
+        else if (flag == "--longest-queries") options.longestQueries = stoi(value);
+        else if (flag == "--longest-budget-ms") options.longestBudgetMs = stoll(value);
+        else if (flag == "--deletes") options.deletes = stoi(value);
+        else if (flag == "--repeats") options.repeats = stoi(value);
+        else if (flag == "--dir") options.dir = value;
+        else if (flag == "--output") options.output = value;
+        else {
+            cerr << "Error: Unknown option " << flag << "\n";
+            return false;
+        }
+    }
+    if (options.topology != "geometric" && options.topology != "grid" &&
+        options.topology != "scalefree") {
+        cerr << "Error: Topology must be geometric, grid or scalefree.\n";
+        return false;
+    }
+    if (options.hospitals < 2) {
+        cerr << "Error: At least 2 hospitals are needed.\n";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) return 1;
+    } catch (const exception&) {
+        cerr << "Error: Option values must be numbers.\n";
+        return 1;
+    }
+
+    mt19937 rng(options.seed);
+    vector<SyntheticEdge> edges;
+    if (options.topology == "geometric") edges = generateGeometric(options.hospitals, options.edges, rng);
+    else if (options.topology == "grid") edges = generateGrid(options.hospitals, rng);
+    else edges = generateScaleFree(options.hospitals, options.edges, rng);
+
+    vector<string> ids(options.hospitals);
+    for (int i = 0; i < options.hospitals; i++) ids[i] = "H" + to_string(i + 1);
+
+    // HospitalNetwork reads and writes its files in the working directory
+    filesystem::path home = filesystem::current_path();
+    filesystem::path scratch;
+    try {
+        scratch = filesystem::absolute(createScratchDirectory(
+            options.dir.empty() ? filesystem::temp_directory_path() : filesystem::path(options.dir)));
+    } catch (const exception& error) {
+        cerr << "Error: " << error.what() << "\n";
+        return 1;
+    }
+    filesystem::current_path(scratch);
+
+    NullBuffer nullBuffer;
+    streambuf* console = cout.rdbuf(&nullBuffer);
+
+    LatencySeries addHospital{"addHospital", {}};
+    LatencySeries addConnection{"addConnection", {}};
+    LatencySeries commitBatch{"commitBatch", {}};
+    LatencySeries saveData{"saveData", {}};
+    LatencySeries loadData{"loadData", {}};
+    LatencySeries shortestPath{"findShortestPath", {}};
+    LatencySeries longestPath{"findLongestPath", {}};
+    LatencySeries deleteHospital{"deleteHospital", {}};
+    int longestIncomplete = 0;
+
+    // Build: one batch, so the read view is built once, by the first query
+    {
+        HospitalNetwork network;
+        uniform_int_distribution<int> patients(0, 500);
+        network.beginBatch();
+        for (const string& id : ids) {
+            int count = patients(rng);
+            timeOnce(addHospital, [&] { network.addHospital(id, "Hospital " + id, "Zone", count); });
+        }
+        for (const SyntheticEdge& edge : edges) {
+            timeOnce(addConnection, [&] {
+                network.addConnection(ids[edge.from], ids[edge.to], "Route", edge.distance);
+            });
+        }
+        timeOnce(commitBatch, [&] { network.commitBatch(); });
+
+        for (int r = 0; r < options.repeats; r++) {
+            timeOnce(saveData, [&] { network.saveData(); });
+        }
+    }
+
+    // Each load is a fresh network reading the saved files; the previous
+    // network's final save happens before the timer starts. Queries and
+    // deletes then run on the last one loaded.
+    {
+        unique_ptr<HospitalNetwork> loaded;
+        for (int r = 0; r < max(1, options.repeats); r++) {
+            loaded.reset();
+            timeOnce(loadData, [&] { loaded = make_unique<HospitalNetwork>(); });
+        }
+        HospitalNetwork& network = *loaded;
+
+        uniform_int_distribution<int> pick(0, options.hospitals - 1);
+        for (int q = 0; q < options.queries; q++) {
+            string start = ids[pick(rng)], end = ids[pick(rng)];
+            timeOnce(shortestPath, [&] { network.view()->shortestPath(start, end); });
+        }
+
+        SearchBudget budget;
+        budget.timeLimitMs = options.longestBudgetMs;
+        for (int q = 0; q < options.longestQueries; q++) {
+            string start = ids[pick(rng)], end = ids[pick(rng)];
+            bool complete = true;
+            timeOnce(longestPath, [&] { network.view()->longestPath(start, end, budget, complete); });
+            if (!complete) longestIncomplete++;
+        }
+
+        // Single deletes outside a batch; the read view is only rebuilt by
+        // the next query, so it is not part of the delete
+        vector<int> order(options.hospitals);
+        for (int i = 0; i < options.hospitals; i++) order[i] = i;
+        shuffle(order.begin(), order.end(), rng);
+        for (int d = 0; d < min(options.deletes, options.hospitals); d++) {
+            timeOnce(deleteHospital, [&] { network.deleteHospital(ids[order[d]]); });
+        }
+    }
+
+    cout.rdbuf(console);
+    string report = toJson(options, edges.size(),
+                           {addHospital, addConnection, commitBatch, saveData, loadData,
+                            shortestPath, longestPath, deleteHospital},
+                           longestIncomplete);
+
+    filesystem::current_path(home);
+    filesystem::remove_all(scratch);
+    if (options.output.empty()) {
+        cout << report;
+    } else {
+        ofstream file(options.output);
+        if (!file.is_open()) {
+            cerr << "Error: Could not write " << options.output << "\n";
+            return 1;
+        }
+        file << report;
+    }
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include "bulk_loader.h"
+#include "hospital.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+const size_t BulkLoadReport::MAX_KEPT_ERRORS;
+
+// Files smaller than this are parsed on the calling thread
+static const size_t MIN_PARALLEL_BYTES = 1 << 20;
+
+void BulkLoadReport::reject(const string& file, size_t line, const string& message) {
+    rowsRejected++;
+    if (errors.size() < MAX_KEPT_ERRORS) {
+        errors.push_back({file, line, message});
+    }
+}
+
+string BulkLoadReport::summary() const {
+    stringstream ss;
+    ss << "Loaded " << hospitalsLoaded << " hospitals and "
+       << connectionsLoaded << " connections";
+    if (rowsRejected > 0) {
+        ss << "; " << rowsRejected << " rows rejected";
+        size_t shown = min<size_t>(errors.size(), 5);
+        for (size_t i = 0; i < shown; i++) {
+            ss << "\n  " << errors[i].file << ":" << errors[i].line
+               << ": " << errors[i].message;
+        }
+        if (rowsRejected > shown) ss << "\n  ...";
+    }
+    return ss.str();
+}
+
+// Rows and problems found in one newline-aligned slice of the file
+template <typename Row>
+struct ChunkResult {
+    vector<Row> rows;
+    vector<pair<size_t, string>> errors;    // (chunk-local line, message)
+    size_t lineCount = 0;
+};
+
+// Split data into roughly equal parts, each ending just after a newline,
+// parse them in parallel and renumber lines relative to the whole file
+template <typename Row, typename ParseLine>
+static void parseInChunks(const MappedFile& file, const string& filename, unsigned threads,
+                          size_t skipLines, ParseLine parseLine,
+                          vector<Row>& rows, BulkLoadReport& report) {
+    const char* data = file.getData();
+    size_t size = file.getSize();
+
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    if (size < MIN_PARALLEL_BYTES) threads = 1;
+
+    vector<const char*> bounds(1, data);
+    for (unsigned i = 1; i < threads; i++) {
+        const char* cut = max(bounds.back(), data + size * i / threads);
+        const char* newline = find(cut, data + size, '\n');
+        bounds.push_back(newline == data + size ? newline : newline + 1);
+    }
+    bounds.push_back(data + size);
+
+    vector<ChunkResult<Row>> results(bounds.size() - 1);
+    auto work = [&](size_t chunk) {
+        ChunkResult<Row>& result = results[chunk];
+        const char* at = bounds[chunk];
+        const char* end = bounds[chunk + 1];
+        while (at < end) {
+            const char* lineEnd = find(at, end, '\n');
+            const char* textEnd = (lineEnd > at && lineEnd[-1] == '\r') ? lineEnd - 1 : lineEnd;
+            result.lineCount++;
+
+            bool skipped = (chunk == 0 && result.lineCount <= skipLines);
+            if (!skipped && textEnd > at) {
+                parseLine(at, textEnd, result.lineCount, result.rows, result.errors);
+            }
+            at = (lineEnd < end) ? lineEnd + 1 : end;
+        }
+    };
+
+    vector<thread> pool;
+    for (size_t i = 1; i < results.size(); i++) pool.emplace_back(work, i);
+    work(0);
+    for (auto& t : pool) t.join();
+
+    size_t baseLine = 0;
+    for (auto& result : results) {
+        for (auto& row : result.rows) {
+            row.line += baseLine;
+            rows.push_back(move(row));
+        }
+        for (const auto& error : result.errors) {
+            report.reject(filename, error.first + baseLine, error.second);
+        }
+        baseLine += result.lineCount;
+    }
+}
+
+// Split [begin, end) on a delimiter
+static vector<string> splitFields(const char* begin, const char* end, char delimiter) {
+    vector<string> fields;
+    const char* at = begin;
+    while (true) {
+        const char* next = find(at, end, delimiter);
+        fields.emplace_back(at, next);
+        if (next == end) break;
+        at = next + 1;
+    }
+    return fields;
+}
+
+// An empty file cannot be mapped but is still a valid (empty) import
+static bool fileIsEmpty(const string& filename) {
+    ifstream probe(filename, ios::binary | ios::ate);
+    return probe.is_open() && probe.tellg() == 0;
+}
+
+static bool parseCount(const string& text, int& value) {
+    if (text.empty() || text.size() > 9) return false;
+    value = 0;
+    for (char c : text) {
+        if (c < '0' || c > '9') return false;
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+bool BulkLoader::parseHospitals(const string& filename, vector<ParsedHospital>& hospitals,
+                                BulkLoadReport& report, unsigned threads) {
+    MappedFile file;
+    if (!file.open(filename)) return fileIsEmpty(filename);
+
+    auto parseLine = [](const char* begin, const char* end, size_t line,
+                        vector<ParsedHospital>& rows, vector<pair<size_t, string>>& errors) {
+        vector<string> fields = splitFields(begin, end, ',');
+        ParsedHospital row;
+        if (fields.size() != 4) {
+            errors.push_back({line, "expected ID,Name,Location,PatientCount"});
+            return;
+        }
+        if (!parseCount(fields[3], row.patientCount)) {
+            errors.push_back({line, "patient count must be a non-negative number"});
+            return;
+        }
+        row.id = move(fields[0]);
+        row.name = move(fields[1]);
+        row.location = move(fields[2]);
+        row.line = line;
+        rows.push_back(move(row));
+    };
+
+    vector<ParsedHospital> parsed;
+    parseInChunks(file, filename, threads, 1, parseLine, parsed, report);
+
+    // Batch validation: ID format, then duplicates (first occurrence wins)
+    sort(parsed.begin(), parsed.end(), [](const ParsedHospital& a, const ParsedHospital& b) {
+        return a.id != b.id ? a.id < b.id : a.line < b.line;
+    });
+    hospitals.reserve(parsed.size());
+    for (auto& row : parsed) {
+        if (!Hospital::isValidId(row.id)) {
+            report.reject(filename, row.line, "invalid hospital ID '" + row.id + "'");
+        } else if (!hospitals.empty() && hospitals.back().id == row.id) {
+            report.reject(filename, row.line, "duplicate hospital ID '" + row.id + "'");
+        } else {
+            hospitals.push_back(move(row));
+        }
+    }
+    return true;
+}
+
+bool BulkLoader::parseConnections(const string& filename, vector<ParsedConnection>& connections,
+                                  BulkLoadReport& report, unsigned threads) {
+    MappedFile file;
+    if (!file.open(filename)) return fileIsEmpty(filename);
+
+    // Line format: H1,H2:description,H3:description
+    auto parseLine = [](const char* begin, const char* end, size_t line,
+                        vector<ParsedConnection>& rows, vector<pair<size_t, string>>& errors) {
+        vector<string> fields = splitFields(begin, end, ',');
+        for (size_t i = 1; i < fields.size(); i++) {
+            size_t colon = fields[i].find(':');
+            if (colon == string::npos) {
+                errors.push_back({line, "connection '" + fields[i] + "' has no ':'"});
+                continue;
+            }
+            ParsedConnection row;
+            row.from = fields[0];
+            row.to = fields[i].substr(0, colon);
+            row.description = fields[i].substr(colon + 1);
+            row.line = line;
+            rows.push_back(move(row));
+        }
+    };
+
+    parseInChunks(file, filename, threads, 0, parseLine, connections, report);
+    return true;
+}
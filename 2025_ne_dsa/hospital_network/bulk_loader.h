@@ -0,0 +1,63 @@
+/**
+ * Bulk Loader Header
+ *
+ * Parses hospitals.csv and graph.txt for a bulk import. The file is
+ * memory mapped and split into newline-aligned chunks that are parsed on
+ * separate threads. Rows are then validated in one batch pass, and
+ * problems are collected in a BulkLoadReport instead of being printed one
+ * row at a time.
+ */
+
+#ifndef BULK_LOADER_H
+#define BULK_LOADER_H
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct ParsedHospital {
+    string id;
+    string name;
+    string location;
+    int patientCount = 0;
+    size_t line = 0;
+};
+
+struct ParsedConnection {
+    string from;
+    string to;
+    string description;
+    size_t line = 0;
+};
+
+struct BulkLoadError {
+    string file;
+    size_t line;
+    string message;
+};
+
+struct BulkLoadReport {
+    static const size_t MAX_KEPT_ERRORS = 100;
+
+    size_t hospitalsLoaded = 0;
+    size_t connectionsLoaded = 0;
+    size_t rowsRejected = 0;
+    vector<BulkLoadError> errors;       // First MAX_KEPT_ERRORS problems
+
+    void reject(const string& file, size_t line, const string& message);
+    string summary() const;
+};
+
+class BulkLoader {
+public:
+    // Both return false only when the file cannot be opened.
+    // Hospitals come back sorted by ID with invalid and duplicate rows
+    // already rejected.
+    static bool parseHospitals(const string& filename, vector<ParsedHospital>& hospitals,
+                               BulkLoadReport& report, unsigned threads = 0);
+    static bool parseConnections(const string& filename, vector<ParsedConnection>& connections,
+                                 BulkLoadReport& report, unsigned threads = 0);
+};
+
+#endif // BULK_LOADER_H
@@ -0,0 +1,114 @@
+#include "connectivity_index.h"
+
+using namespace std;
+
+// Union-find
+int ConnectivityIndex::find(int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];      // Path halving
+        x = parent[x];
+    }
+    return x;
+}
+
+void ConnectivityIndex::unite(int a, int b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) return;
+    if (size[a] < size[b]) swap(a, b);
+    parent[b] = a;
+    size[a] += size[b];
+}
+
+int ConnectivityIndex::elementOf(const string& id) {
+    auto it = element.find(id);
+    if (it != element.end()) return it->second;
+
+    int x = (int)parent.size();
+    element.emplace(id, x);
+    parent.push_back(x);
+    size.push_back(1);
+    return x;
+}
+
+// Updates. While stale the index is rebuilt anyway, so they are skipped.
+void ConnectivityIndex::addHospital(const string& id) {
+    if (!stale) elementOf(id);
+}
+
+void ConnectivityIndex::connect(const string& id1, const string& id2) {
+    if (!stale) unite(elementOf(id1), elementOf(id2));
+}
+
+void ConnectivityIndex::invalidate() {
+    stale = true;
+}
+
+// Edges are read from the CSR by vertex number, so only the vertices
+// themselves need an ID lookup
+void ConnectivityIndex::refresh(const NetworkGraph& graph) {
+    int n = graph.vertexCount();
+    element.clear();
+    parent.clear();
+    size.clear();
+    element.reserve(n);
+    parent.reserve(n);
+    size.reserve(n);
+
+    vector<int> elementOfVertex(n, -1);
+    for (int v = 0; v < n; v++) {
+        if (!graph.isRemoved(v)) elementOfVertex[v] = elementOf(graph.idOf(v));
+    }
+
+    const vector<int>& offsets = graph.getOffsets();
+    const vector<int>& targets = graph.getTargets();
+    for (int v = 0; v < n; v++) {
+        if (elementOfVertex[v] == -1) continue;
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            int to = targets[e];
+            if (to != NetworkGraph::NO_VERTEX && elementOfVertex[to] != -1) {
+                unite(elementOfVertex[v], elementOfVertex[to]);
+            }
+        }
+    }
+    stale = false;
+}
+
+// Flattening
+NetworkComponents ConnectivityIndex::label(const NetworkGraph& graph) {
+    if (stale) refresh(graph);
+
+    NetworkComponents result;
+    int n = graph.vertexCount();
+    result.label.assign(n, -1);
+
+    // Resolve every vertex first: elementOf may add elements
+    for (int v = 0; v < n; v++) {
+        if (!graph.isRemoved(v)) result.label[v] = elementOf(graph.idOf(v));
+    }
+
+    // Number the roots in order of first appearance
+    vector<int> labelOfRoot(parent.size(), -1);
+    int count = 0;
+    for (int v = 0; v < n; v++) {
+        if (result.label[v] == -1) continue;
+        int root = find(result.label[v]);
+        if (labelOfRoot[root] == -1) labelOfRoot[root] = count++;
+        result.label[v] = labelOfRoot[root];
+    }
+
+    // Counting sort of the vertices by component
+    result.offsets.assign(count + 1, 0);
+    for (int v = 0; v < n; v++) {
+        if (result.label[v] != -1) result.offsets[result.label[v] + 1]++;
+    }
+    for (int c = 0; c < count; c++) {
+        result.offsets[c + 1] += result.offsets[c];
+    }
+    result.members.resize(result.offsets[count]);
+    vector<int> next(result.offsets.begin(), result.offsets.end() - 1);
+    for (int v = 0; v < n; v++) {
+        if (result.label[v] != -1) result.members[next[result.label[v]]++] = v;
+    }
+    return result;
+}
@@ -0,0 +1,62 @@
+/**
+ * Connectivity Index Header
+ *
+ * Tracks which hospitals can reach each other at all, without a path
+ * search. A union-find over hospital IDs (union by size, path halving)
+ * absorbs new hospitals and connections in O(α(n)) each.
+ *
+ * Union-find cannot split a component, so removing a connection or a
+ * hospital only marks the index stale. It is rebuilt from the CSR graph
+ * the next time it is read, which folds any number of removals in a
+ * batch into one O(V + E) pass.
+ *
+ * Readers never touch the union-find itself: each published view gets a
+ * flat NetworkComponents table (component per graph vertex plus the
+ * members of each component), so connected(a, b) is two array reads.
+ */
+
+#ifndef CONNECTIVITY_INDEX_H
+#define CONNECTIVITY_INDEX_H
+
+#include "network_graph.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Frozen component labels for one NetworkGraph
+struct NetworkComponents {
+    vector<int> label;          // Component per graph vertex (-1 = removed)
+    vector<int> offsets;        // Component c holds members[offsets[c] .. offsets[c + 1])
+    vector<int> members;        // Graph vertices grouped by component
+
+    int count() const { return offsets.empty() ? 0 : (int)offsets.size() - 1; }
+};
+
+class ConnectivityIndex {
+public:
+    // Insertions, applied immediately
+    void addHospital(const string& id);
+    void connect(const string& id1, const string& id2);
+
+    // Removals: the index is rebuilt on next use
+    void invalidate();
+
+    // Labels for every live vertex of graph, which must be current (its
+    // edges are only read when the index is stale)
+    NetworkComponents label(const NetworkGraph& graph);
+
+private:
+    unordered_map<string, int> element;     // Hospital ID -> union-find element
+    vector<int> parent;
+    vector<int> size;                       // Component size, valid at roots
+    bool stale = true;
+
+    int find(int x);
+    void unite(int a, int b);
+    int elementOf(const string& id);
+    void refresh(const NetworkGraph& graph);
+};
+
+#endif // CONNECTIVITY_INDEX_H
@@ -0,0 +1,389 @@
+#include "contraction_hierarchy.h"
+#include "file_sync.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+
+using namespace std;
+
+const uint32_t ContractionHierarchy::FORMAT_VERSION;
+const int ContractionHierarchy::WITNESS_SETTLE_LIMIT;
+
+static const char HIERARCHY_MAGIC[8] = {'H', 'N', 'C', 'H', 0, 0, 0, 0};
+
+// Connection of a vertex that is not contracted yet
+struct WorkArc {
+    int to;
+    double weight;
+    int middle;
+};
+
+// Keep only the lightest arc between two vertices
+static void addOrImprove(vector<WorkArc>& arcs, int to, double weight, int middle) {
+    for (auto& arc : arcs) {
+        if (arc.to == to) {
+            if (weight < arc.weight) {
+                arc.weight = weight;
+                arc.middle = middle;
+            }
+            return;
+        }
+    }
+    arcs.push_back({to, weight, middle});
+}
+
+// Bounded Dijkstra from source that never passes through skip. Gives up
+// after WITNESS_SETTLE_LIMIT vertices; a missed witness only costs an
+// unnecessary shortcut, never a wrong answer.
+static void witnessSearch(const vector<vector<WorkArc>>& work, int source, int skip,
+                          double limit, PathWorkspace& ws) {
+    ws.reset((int)work.size());
+    auto cmp = greater<pair<double, int>>();
+    ws.dist[source] = 0;
+    ws.touched.push_back(source);
+    ws.heap.push_back({0, source});
+
+    int settled = 0;
+    while (!ws.heap.empty() && settled < ContractionHierarchy::WITNESS_SETTLE_LIMIT) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), cmp);
+        pair<double, int> top = ws.heap.back();
+        ws.heap.pop_back();
+
+        int current = top.second;
+        if (top.first > ws.dist[current]) continue;
+        if (top.first > limit) break;
+        settled++;
+
+        for (const auto& arc : work[current]) {
+            if (arc.to == skip) continue;
+            double candidate = top.first + arc.weight;
+            if (candidate < ws.dist[arc.to]) {
+                if (ws.dist[arc.to] == numeric_limits<double>::infinity()) {
+                    ws.touched.push_back(arc.to);
+                }
+                ws.dist[arc.to] = candidate;
+                ws.heap.push_back({candidate, arc.to});
+                push_heap(ws.heap.begin(), ws.heap.end(), cmp);
+            }
+        }
+    }
+}
+
+// Shortcuts needed to contract v, as (u, w, weight) with u listed before w
+// among v's neighbours. Each unordered pair is reported once.
+struct Shortcut {
+    int from;
+    int to;
+    double weight;
+};
+
+static void findShortcuts(const vector<vector<WorkArc>>& work, int v, PathWorkspace& ws,
+                          vector<Shortcut>& shortcuts) {
+    shortcuts.clear();
+    const vector<WorkArc>& arcs = work[v];
+    if (arcs.size() < 2) return;
+
+    double heaviest = 0;
+    for (const auto& arc : arcs) heaviest = max(heaviest, arc.weight);
+
+    for (size_t i = 0; i + 1 < arcs.size(); i++) {
+        witnessSearch(work, arcs[i].to, v, arcs[i].weight + heaviest, ws);
+        for (size_t j = i + 1; j < arcs.size(); j++) {
+            double via = arcs[i].weight + arcs[j].weight;
+            if (ws.dist[arcs[j].to] > via) {
+                shortcuts.push_back({arcs[i].to, arcs[j].to, via});
+            }
+        }
+    }
+}
+
+// Building
+ContractionHierarchy ContractionHierarchy::build(const NetworkGraph& graph) {
+    int n = graph.vertexCount();
+    const vector<int>& graphOffsets = graph.getOffsets();
+    const vector<int>& graphTargets = graph.getTargets();
+    const vector<double>& graphWeights = graph.getWeights();
+
+    vector<vector<WorkArc>> work(n);
+    for (int v = 0; v < n; v++) {
+        for (int e = graphOffsets[v]; e < graphOffsets[v + 1]; e++) {
+            int to = graphTargets[e];
+            if (to == NetworkGraph::NO_VERTEX || to == v) continue;
+            addOrImprove(work[v], to, graphWeights[e], NetworkGraph::NO_VERTEX);
+        }
+    }
+
+    // Priority: shortcuts added minus arcs removed, plus neighbours already
+    // contracted (spreads contraction evenly over the network)
+    vector<int> contractedNeighbours(n, 0);
+    PathWorkspace ws;
+    vector<Shortcut> shortcuts;
+    auto priorityOf = [&](int v) {
+        findShortcuts(work, v, ws, shortcuts);
+        return (int)shortcuts.size() - (int)work[v].size() + contractedNeighbours[v];
+    };
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> candidates;
+    for (int v = 0; v < n; v++) {
+        candidates.push({priorityOf(v), v});
+    }
+
+    ContractionHierarchy hierarchy;
+    hierarchy.rank.assign(n, -1);
+    vector<vector<WorkArc>> upward(n);
+    int order = 0;
+
+    while (!candidates.empty()) {
+        int v = candidates.top().second;
+        candidates.pop();
+        if (hierarchy.rank[v] != -1) continue;
+
+        // Lazy update: contract v only if it is still the cheapest
+        int priority = priorityOf(v);
+        if (!candidates.empty() && priority > candidates.top().first) {
+            candidates.push({priority, v});
+            continue;
+        }
+
+        // Every arc still attached to v leads to a later (higher) vertex
+        hierarchy.rank[v] = order++;
+        upward[v] = work[v];
+        for (const auto& arc : work[v]) {
+            vector<WorkArc>& back = work[arc.to];
+            back.erase(remove_if(back.begin(), back.end(),
+                                 [v](const WorkArc& other) { return other.to == v; }),
+                       back.end());
+            contractedNeighbours[arc.to]++;
+        }
+        for (const auto& shortcut : shortcuts) {
+            addOrImprove(work[shortcut.from], shortcut.to, shortcut.weight, v);
+            addOrImprove(work[shortcut.to], shortcut.from, shortcut.weight, v);
+        }
+        work[v].clear();
+        work[v].shrink_to_fit();
+    }
+
+    // Flatten the upward arcs into CSR form
+    hierarchy.offsets.assign(1, 0);
+    hierarchy.offsets.reserve(n + 1);
+    for (int v = 0; v < n; v++) {
+        for (const auto& arc : upward[v]) {
+            hierarchy.arcs.push_back({arc.to, arc.middle, arc.weight});
+            if (arc.middle != NetworkGraph::NO_VERTEX) hierarchy.shortcuts++;
+        }
+        hierarchy.offsets.push_back((uint32_t)hierarchy.arcs.size());
+    }
+    hierarchy.graphFingerprint = fingerprint(graph);
+    return hierarchy;
+}
+
+// Querying
+vector<int> ContractionHierarchy::shortestPath(int source, int target, PathWorkspace& forward,
+                                               PathWorkspace& backward, double& distance) const {
+    int n = vertexCount();
+    distance = numeric_limits<double>::infinity();
+    forward.reset(n);
+    backward.reset(n);
+    if (source < 0 || source >= n || target < 0 || target >= n) return vector<int>();
+
+    auto cmp = greater<pair<double, int>>();
+    for (auto side : {make_pair(&forward, source), make_pair(&backward, target)}) {
+        side.first->dist[side.second] = 0;
+        side.first->touched.push_back(side.second);
+        side.first->heap.push_back({0, side.second});
+    }
+
+    // Each side stops once its closest open vertex is no better than the
+    // best meeting point found so far
+    int meet = NetworkGraph::NO_VERTEX;
+    auto open = [&](const PathWorkspace& ws) {
+        return !ws.heap.empty() && ws.heap.front().first < distance;
+    };
+    while (open(forward) || open(backward)) {
+        bool forwardTurn = open(forward) &&
+            (!open(backward) || forward.heap.front().first <= backward.heap.front().first);
+        PathWorkspace& ws = forwardTurn ? forward : backward;
+        const PathWorkspace& other = forwardTurn ? backward : forward;
+
+        pop_heap(ws.heap.begin(), ws.heap.end(), cmp);
+        pair<double, int> top = ws.heap.back();
+        ws.heap.pop_back();
+
+        int current = top.second;
+        if (top.first > ws.dist[current]) continue;   // Stale heap entry
+        ws.settled++;
+        if (top.first + other.dist[current] < distance) {
+            distance = top.first + other.dist[current];
+            meet = current;
+        }
+
+        for (uint32_t a = offsets[current]; a < offsets[current + 1]; a++) {
+            const HierarchyArc& arc = arcs[a];
+            double candidate = top.first + arc.weight;
+            if (candidate < ws.dist[arc.target]) {
+                ws.relaxed++;
+                if (ws.dist[arc.target] == numeric_limits<double>::infinity()) {
+                    ws.touched.push_back(arc.target);
+                }
+                ws.dist[arc.target] = candidate;
+                ws.prev[arc.target] = current;
+                ws.heap.push_back({candidate, arc.target});
+                push_heap(ws.heap.begin(), ws.heap.end(), cmp);
+            }
+        }
+    }
+
+    if (meet == NetworkGraph::NO_VERTEX) return vector<int>();
+
+    // Source up to the meeting vertex, then back down to target, with
+    // every shortcut expanded into the connections it stands for
+    vector<int> up = NetworkGraph::extractPath(forward, meet);
+    vector<int> down = NetworkGraph::extractPath(backward, meet);
+    reverse(down.begin(), down.end());
+
+    vector<int> path(1, source);
+    for (size_t i = 0; i + 1 < up.size(); i++) unpack(up[i], up[i + 1], path);
+    for (size_t i = 0; i + 1 < down.size(); i++) unpack(down[i], down[i + 1], path);
+    return path;
+}
+
+// An arc is stored once, at its lower-ranked end
+const HierarchyArc* ContractionHierarchy::findArc(int from, int to) const {
+    int low = (rank[from] < rank[to]) ? from : to;
+    int high = (low == from) ? to : from;
+    for (uint32_t a = offsets[low]; a < offsets[low + 1]; a++) {
+        if (arcs[a].target == high) return &arcs[a];
+    }
+    return nullptr;
+}
+
+// Append the vertices after from up to and including to
+void ContractionHierarchy::unpack(int from, int to, vector<int>& path) const {
+    const HierarchyArc* arc = findArc(from, to);
+    if (!arc || arc->middle == NetworkGraph::NO_VERTEX) {
+        path.push_back(to);
+        return;
+    }
+    int middle = arc->middle;
+    unpack(from, middle, path);
+    unpack(middle, to, path);
+}
+
+// Fingerprint (FNV-1a)
+uint64_t ContractionHierarchy::fingerprint(const NetworkGraph& graph) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t length) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < length; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    int n = graph.vertexCount();
+    mix(&n, sizeof(n));
+    const vector<int>& graphOffsets = graph.getOffsets();
+    const vector<int>& graphTargets = graph.getTargets();
+    const vector<double>& graphWeights = graph.getWeights();
+    for (int v = 0; v < n; v++) {
+        const string& id = graph.idOf(v);
+        mix(id.data(), id.size() + 1);
+        for (int e = graphOffsets[v]; e < graphOffsets[v + 1]; e++) {
+            if (graphTargets[e] == NetworkGraph::NO_VERTEX) continue;
+            mix(&graphTargets[e], sizeof(int));
+            mix(&graphWeights[e], sizeof(double));
+        }
+    }
+    return hash;
+}
+
+bool ContractionHierarchy::matches(const NetworkGraph& graph) const {
+    return vertexCount() == graph.vertexCount() && graphFingerprint == fingerprint(graph);
+}
+
+// File operations
+bool ContractionHierarchy::save(const string& filename) const {
+    HierarchyHeader header = {};
+    memcpy(header.magic, HIERARCHY_MAGIC, sizeof(HIERARCHY_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.vertexCount = (uint32_t)rank.size();
+    header.arcCount = (uint32_t)arcs.size();
+    header.fingerprint = graphFingerprint;
+
+    // Write to a temporary file, then sync and rename it over the old hierarchy
+    string tempName = filename + ".tmp";
+    ofstream out(tempName, ios::binary | ios::trunc);
+    if (!out.is_open()) return false;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(rank.data()), rank.size() * sizeof(int32_t));
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(arcs.data()), arcs.size() * sizeof(HierarchyArc));
+    out.close();
+    if (!out) {
+        remove(tempName.c_str());
+        return false;
+    }
+
+    return replaceFile(tempName, filename);
+}
+
+// Every rank, offset and arc endpoint must be in range before the
+// hierarchy is used
+bool ContractionHierarchy::load(const string& filename) {
+    ifstream in(filename, ios::binary);
+    if (!in.is_open()) return false;
+
+    HierarchyHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, HIERARCHY_MAGIC, sizeof(HIERARCHY_MAGIC)) != 0 ||
+        header.version != FORMAT_VERSION) {
+        return false;
+    }
+
+    uint32_t n = header.vertexCount;
+    vector<int> fileRank(n);
+    vector<uint32_t> fileOffsets(n + 1);
+    vector<HierarchyArc> fileArcs(header.arcCount);
+    in.read(reinterpret_cast<char*>(fileRank.data()), n * sizeof(int32_t));
+    in.read(reinterpret_cast<char*>(fileOffsets.data()), (n + 1) * sizeof(uint32_t));
+    in.read(reinterpret_cast<char*>(fileArcs.data()), fileArcs.size() * sizeof(HierarchyArc));
+    if (!in) return false;
+
+    if (fileOffsets[0] != 0 || fileOffsets[n] != header.arcCount) return false;
+    for (uint32_t v = 0; v < n; v++) {
+        if (fileRank[v] < 0 || (uint32_t)fileRank[v] >= n ||
+            fileOffsets[v] > fileOffsets[v + 1]) {
+            return false;
+        }
+    }
+    // Arcs lead upward and shortcuts bypass a lower vertex, so unpacking
+    // always terminates
+    size_t shortcutArcs = 0;
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint32_t a = fileOffsets[v]; a < fileOffsets[v + 1]; a++) {
+            const HierarchyArc& arc = fileArcs[a];
+            if (arc.target < 0 || (uint32_t)arc.target >= n ||
+                fileRank[arc.target] <= fileRank[v]) {
+                return false;
+            }
+            if (arc.middle == NetworkGraph::NO_VERTEX) continue;
+            if (arc.middle < 0 || (uint32_t)arc.middle >= n ||
+                fileRank[arc.middle] >= fileRank[v]) {
+                return false;
+            }
+            shortcutArcs++;
+        }
+    }
+
+    rank = move(fileRank);
+    offsets = move(fileOffsets);
+    arcs = move(fileArcs);
+    graphFingerprint = header.fingerprint;
+    shortcuts = shortcutArcs;
+    return true;
+}
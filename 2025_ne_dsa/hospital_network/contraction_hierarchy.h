@@ -0,0 +1,88 @@
+/**
+ * Contraction Hierarchy Header
+ *
+ * Optional preprocessing for fast shortest-path queries on large networks.
+ * Vertices are contracted one at a time in order of importance (cheapest
+ * edge difference first). Whenever removing a vertex would lengthen a
+ * shortest path between two of its neighbours, a shortcut edge is added.
+ *
+ * A query then runs Dijkstra from both ends, only ever moving to more
+ * important vertices. The two searches meet at the top of the path and
+ * settle a few hundred vertices instead of most of the network. Shortcuts
+ * remember the vertex they bypass, so paths are unpacked into original
+ * connections.
+ *
+ * The hierarchy is tied to one exact graph: the file stores a fingerprint
+ * of the IDs and edges it was built from, and a hierarchy whose
+ * fingerprint no longer matches must be rebuilt.
+ *
+ * File layout (native byte order):
+ *   HierarchyHeader                     32 bytes
+ *   int32 rank[vertexCount]
+ *   uint32 offsets[vertexCount + 1]     upward arcs per vertex
+ *   HierarchyArc[arcCount]
+ */
+
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+#include "network_graph.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct HierarchyHeader {
+    char magic[8];              // "HNCH\0\0\0\0"
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t arcCount;
+    uint32_t reserved;
+    uint64_t fingerprint;       // Of the graph the hierarchy was built on
+};
+
+// Edge to a more important vertex; middle is the bypassed vertex of a
+// shortcut, or NO_VERTEX for an original connection
+struct HierarchyArc {
+    int32_t target;
+    int32_t middle;
+    double weight;
+};
+
+class ContractionHierarchy {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+    static const int WITNESS_SETTLE_LIMIT = 250;    // Per witness search
+
+    // Contract every vertex of graph (connections must be symmetric)
+    static ContractionHierarchy build(const NetworkGraph& graph);
+
+    // Shortest vertex path from source to target, empty if unreachable.
+    // The two workspaces hold the forward and backward searches.
+    vector<int> shortestPath(int source, int target, PathWorkspace& forward,
+                             PathWorkspace& backward, double& distance) const;
+
+    // Identity of a graph's vertex IDs and live edges
+    static uint64_t fingerprint(const NetworkGraph& graph);
+    bool matches(const NetworkGraph& graph) const;
+
+    int vertexCount() const { return (int)rank.size(); }
+    size_t shortcutCount() const { return shortcuts; }
+
+    // File operations
+    bool save(const string& filename) const;
+    bool load(const string& filename);
+
+private:
+    vector<int> rank;                   // Contraction order per vertex
+    vector<uint32_t> offsets;           // Size n + 1
+    vector<HierarchyArc> arcs;          // Upward arcs, grouped by source vertex
+    uint64_t graphFingerprint = 0;
+    size_t shortcuts = 0;
+
+    const HierarchyArc* findArc(int from, int to) const;
+    void unpack(int from, int to, vector<int>& path) const;
+};
+
+#endif // CONTRACTION_HIERARCHY_H
@@ -0,0 +1,148 @@
+#include "distance_matrix.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <thread>
+
+using namespace std;
+
+DistanceMatrix DistanceMatrix::compute(const NetworkGraph& graph,
+                                       const vector<string>& sourceIds,
+                                       const vector<string>& targetIds,
+                                       bool withPredecessors,
+                                       unsigned threads) {
+    DistanceMatrix matrix;
+    matrix.sources = sourceIds;
+    matrix.targets = targetIds;
+    matrix.distances.assign(sourceIds.size() * targetIds.size(),
+                            numeric_limits<double>::infinity());
+    if (withPredecessors) {
+        matrix.predecessors.resize(sourceIds.size());
+        for (int v = 0; v < graph.vertexCount(); v++) {
+            matrix.vertexIds.push_back(graph.idOf(v));
+        }
+    }
+
+    vector<int> targetVertices;
+    for (const auto& id : targetIds) {
+        targetVertices.push_back(graph.indexOf(id));
+    }
+
+    // Workers claim the next unprocessed source until none are left
+    atomic<size_t> nextSource{0};
+    atomic<long long> settled{0};
+    atomic<long long> relaxed{0};
+    auto work = [&]() {
+        PathWorkspace ws;
+        size_t row;
+        while ((row = nextSource++) < sourceIds.size()) {
+            int source = graph.indexOf(sourceIds[row]);
+            if (source == NetworkGraph::NO_VERTEX) continue;
+
+            graph.shortestPaths(source, NetworkGraph::NO_VERTEX, ws);
+            settled += ws.settled;
+            relaxed += ws.relaxed;
+            double* out = &matrix.distances[row * targetIds.size()];
+            for (size_t col = 0; col < targetVertices.size(); col++) {
+                if (targetVertices[col] != NetworkGraph::NO_VERTEX) {
+                    out[col] = ws.dist[targetVertices[col]];
+                }
+            }
+            if (withPredecessors) {
+                matrix.predecessors[row] = ws.prev;
+            }
+        }
+    };
+
+    if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+    size_t spawned = min<size_t>(threads, sourceIds.size());
+    vector<thread> pool;
+    for (size_t i = 1; i < spawned; i++) pool.emplace_back(work);
+    work();
+    for (auto& t : pool) t.join();
+
+    matrix.verticesSettled = settled;
+    matrix.edgesRelaxed = relaxed;
+    return matrix;
+}
+
+double DistanceMatrix::at(size_t row, size_t col) const {
+    return distances[row * targets.size() + col];
+}
+
+bool DistanceMatrix::hasPredecessors() const {
+    return !predecessors.empty();
+}
+
+vector<string> DistanceMatrix::path(size_t row, size_t col) const {
+    vector<string> result;
+    if (!hasPredecessors() || at(row, col) == numeric_limits<double>::infinity()) {
+        return result;
+    }
+
+    const vector<int>& prev = predecessors[row];
+    int target = -1;
+    for (size_t v = 0; v < vertexIds.size(); v++) {
+        if (vertexIds[v] == targets[col]) target = (int)v;
+    }
+
+    for (int v = target; v != NetworkGraph::NO_VERTEX; v = prev[v]) {
+        result.push_back(vertexIds[v]);
+    }
+    reverse(result.begin(), result.end());
+    return result;
+}
+
+// Export
+bool DistanceMatrix::saveCSV(const string& filename) const {
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << setprecision(numeric_limits<double>::max_digits10);    // Round-trips exactly
+
+    // Header row holds the target IDs
+    file << "Source";
+    for (const auto& id : targets) file << "," << id;
+    file << "\n";
+
+    for (size_t row = 0; row < sources.size(); row++) {
+        file << sources[row];
+        for (size_t col = 0; col < targets.size(); col++) {
+            double d = at(row, col);
+            file << ",";
+            if (d == numeric_limits<double>::infinity()) file << "inf";
+            else file << d;
+        }
+        file << "\n";
+    }
+
+    return true;
+}
+
+// Binary layout (native byte order):
+//   "HDM1", uint32 rows, uint32 cols,
+//   rows + cols IDs as (uint32 length, bytes), then rows * cols doubles
+bool DistanceMatrix::saveBinary(const string& filename) const {
+    ofstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+
+    auto writeU32 = [&](uint32_t value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto writeId = [&](const string& id) {
+        writeU32((uint32_t)id.size());
+        file.write(id.data(), id.size());
+    };
+
+    file.write("HDM1", 4);
+    writeU32((uint32_t)sources.size());
+    writeU32((uint32_t)targets.size());
+    for (const auto& id : sources) writeId(id);
+    for (const auto& id : targets) writeId(id);
+    file.write(reinterpret_cast<const char*>(distances.data()),
+               distances.size() * sizeof(double));
+
+    return file.good();
+}
@@ -0,0 +1,51 @@
+/**
+ * Distance Matrix Header
+ *
+ * Dense many-to-many shortest distances between a list of source hospitals
+ * (e.g. ambulance depots) and a list of target hospitals. Each source is
+ * one single-source Dijkstra over the NetworkGraph, and sources are spread
+ * across a pool of worker threads.
+ *
+ * Unreachable pairs and unknown hospital IDs hold infinity.
+ */
+
+#ifndef DISTANCE_MATRIX_H
+#define DISTANCE_MATRIX_H
+
+#include "network_graph.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class DistanceMatrix {
+public:
+    vector<string> sources;
+    vector<string> targets;
+    vector<double> distances;               // Row-major, sources x targets
+
+    // Optional: predecessor vertex per graph vertex, one array per source
+    vector<vector<int>> predecessors;
+    vector<string> vertexIds;               // Vertex number -> hospital ID
+
+    // Search work summed over all sources
+    long long verticesSettled = 0;
+    long long edgesRelaxed = 0;
+
+    // Run one search per source on `threads` workers (0 = all cores)
+    static DistanceMatrix compute(const NetworkGraph& graph,
+                                  const vector<string>& sourceIds,
+                                  const vector<string>& targetIds,
+                                  bool withPredecessors = false,
+                                  unsigned threads = 0);
+
+    double at(size_t row, size_t col) const;
+    bool hasPredecessors() const;
+    vector<string> path(size_t row, size_t col) const;
+
+    // Export
+    bool saveCSV(const string& filename) const;
+    bool saveBinary(const string& filename) const;
+};
+
+#endif // DISTANCE_MATRIX_H
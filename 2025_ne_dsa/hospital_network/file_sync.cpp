@@ -0,0 +1,66 @@
+#include "file_sync.h"
+#include <cstdio>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef _WIN32
+
+static bool syncFile(const string& filename) {
+    int fd = _open(filename.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) return false;
+    bool synced = _commit(fd) == 0;
+    _close(fd);
+    return synced;
+}
+
+// NTFS journals directory changes itself; there is no handle to flush
+static bool syncDirectory(const string&) {
+    return true;
+}
+
+#else
+
+static bool syncFile(const string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+static bool syncDirectory(const string& directory) {
+    int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+}
+
+#endif
+
+bool replaceFile(const string& tempName, const string& filename) {
+    if (!syncFile(tempName)) {
+        remove(tempName.c_str());
+        return false;
+    }
+
+#ifdef _WIN32
+    remove(filename.c_str());   // rename() does not replace on Windows
+#endif
+    if (rename(tempName.c_str(), filename.c_str()) != 0) {
+        remove(tempName.c_str());
+        return false;
+    }
+
+    filesystem::path directory = filesystem::path(filename).parent_path();
+    return syncDirectory(directory.empty() ? "." : directory.string());
+}
@@ -0,0 +1,22 @@
+/**
+ * File Sync Header
+ *
+ * Crash-safe replacement of a whole file. The caller writes the new
+ * contents to a temporary file; replaceFile then flushes it to disk,
+ * renames it over the target and flushes the directory entry, so after a
+ * crash the target holds either the complete old or the complete new
+ * contents, and a successful return means the new contents are durable.
+ */
+
+#ifndef FILE_SYNC_H
+#define FILE_SYNC_H
+
+#include <string>
+
+using namespace std;
+
+// Sync tempName, rename it to filename and sync the directory. The
+// temporary file is removed if any step fails.
+bool replaceFile(const string& tempName, const string& filename);
+
+#endif // FILE_SYNC_H
@@ -1,15 +1,18 @@
 #include "hospital.h"
+#include "string_pool.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
 
 // Default constructor
-Hospital::Hospital() : patientCount(0) {}
+Hospital::Hospital() : id(""), name(""), location(""), patientCount(0) {}
 
 // Parameterized constructor
-Hospital::Hospital(const string& id, const string& name, 
-                  const string& location, int patientCount)
+Hospital::Hospital(const char* id, const char* name, 
+                  const char* location, int patientCount)
     : id(id), name(name), location(location), patientCount(patientCount) {}
 
 // Getters
@@ -17,33 +20,78 @@ string Hospital::getId() const { return id; }
 string Hospital::getName() const { return name; }
 string Hospital::getLocation() const { return location; }
 int Hospital::getPatientCount() const { return patientCount; }
-map<string, string> Hospital::getConnections() const { return connections; }
+const ConnectionList& Hospital::getConnectionView() const { return connections; }
+
+map<string, string> Hospital::getConnections() const {
+    map<string, string> result;
+    for (const auto& conn : connections) {
+        result[conn.first] = conn.second.description;
+    }
+    return result;
+}
 
 // Setters
-void Hospital::setName(const string& name) { this->name = name; }
-void Hospital::setLocation(const string& location) { this->location = location; }
+void Hospital::setName(const char* name) { this->name = name; }
+void Hospital::setLocation(const char* location) { this->location = location; }
 void Hospital::setPatientCount(int count) { this->patientCount = count; }
 
-// Connection management
-void Hospital::addConnection(const string& hospitalId, const string& description) {
-    connections[hospitalId] = description;
+// Connection management (binary search on the sorted list)
+static bool idBefore(const pair<const char*, Connection>& entry, const char* hospitalId) {
+    return strcmp(entry.first, hospitalId) < 0;
+}
+
+ConnectionList::iterator Hospital::findConnection(const string& hospitalId) {
+    auto it = lower_bound(connections.begin(), connections.end(), hospitalId.c_str(), idBefore);
+    return (it != connections.end() && hospitalId == it->first) ? it : connections.end();
+}
+
+ConnectionList::const_iterator Hospital::findConnection(const string& hospitalId) const {
+    auto it = lower_bound(connections.begin(), connections.end(), hospitalId.c_str(), idBefore);
+    return (it != connections.end() && hospitalId == it->first) ? it : connections.end();
+}
+
+void Hospital::addConnection(const char* hospitalId, const char* description,
+                             double distance) {
+    auto it = lower_bound(connections.begin(), connections.end(), hospitalId, idBefore);
+    if (it == connections.end() || strcmp(it->first, hospitalId) != 0) {
+        it = connections.insert(it, {hospitalId, Connection()});
+    }
+    it->second.description = description;
+    it->second.distance = distance;
 }
 
 void Hospital::removeConnection(const string& hospitalId) {
-    connections.erase(hospitalId);
+    auto it = findConnection(hospitalId);
+    if (it != connections.end()) connections.erase(it);
+}
+
+// Connections stay sorted: the same text compares the same in any pool
+void Hospital::reintern(StringPool& pool) {
+    id = pool.intern(id);
+    name = pool.intern(name);
+    location = pool.intern(location);
+    for (auto& conn : connections) {
+        conn.first = pool.intern(conn.first);
+        conn.second.description = pool.intern(conn.second.description);
+    }
 }
 
 bool Hospital::hasConnection(const string& hospitalId) const {
-    return connections.find(hospitalId) != connections.end();
+    return findConnection(hospitalId) != connections.end();
 }
 
 string Hospital::getConnectionDescription(const string& hospitalId) const {
-    auto it = connections.find(hospitalId);
-    return (it != connections.end()) ? it->second : "";
+    auto it = findConnection(hospitalId);
+    return (it != connections.end()) ? it->second.description : "";
+}
+
+double Hospital::getConnectionDistance(const string& hospitalId) const {
+    auto it = findConnection(hospitalId);
+    return (it != connections.end()) ? it->second.distance : 0.0;
 }
 
 void Hospital::clearConnections() {
-    connections.clear();
+    ConnectionList().swap(connections);
 }
 
 // Data validation
@@ -4,52 +4,84 @@
  * This class represents a hospital in our network management system.
  * It stores all the essential information about a hospital and provides
  * methods to manage its data.
+ *
+ * Text fields are interned: a Hospital holds pointers into the owning
+ * network's StringPool, so copies are cheap and a repeated name or
+ * description is stored once. Strings passed in must outlive the
+ * hospital (interned strings and literals do). For that reason the
+ * mutators are private to HospitalNetwork, which interns every string it
+ * stores and journals every change; everyone else gets const access.
  */
 
 #ifndef HOSPITAL_H
 #define HOSPITAL_H
 
 #include <string>
+#include <utility>
 #include <vector>
 #include <map>
 
 using namespace std;
 
+class HospitalNetwork;
+class StringPool;
+
+// A link to another hospital: description and distance kept together
+struct Connection {
+    const char* description = "";
+    double distance = 0.0;
+};
+
+// Connected hospital ID -> connection details, kept sorted by ID in one
+// flat array (24 bytes per entry instead of a map node with two strings)
+typedef vector<pair<const char*, Connection>> ConnectionList;
+
 class Hospital {
 private:
-    string id;          // Unique identifier (e.g., H1, H2)
-    string name;        // Hospital name
-    string location;    // Hospital location
+    const char* id;          // Unique identifier (e.g., H1, H2)
+    const char* name;        // Hospital name
+    const char* location;    // Hospital location
     int patientCount;        // Number of patients
     
-    // Map to store connections with other hospitals
-    // Key: Connected hospital ID, Value: Connection description
-    map<string, string> connections;
+    // Connections with other hospitals, sorted by connected hospital ID
+    ConnectionList connections;
+    
+    ConnectionList::iterator findConnection(const string& hospitalId);
+    ConnectionList::const_iterator findConnection(const string& hospitalId) const;
+    
+    // Mutators, for HospitalNetwork only
+    friend class HospitalNetwork;
+    
+    void setName(const char* name);
+    void setLocation(const char* location);
+    void setPatientCount(int count);
+    
+    void addConnection(const char* hospitalId, const char* description,
+                       double distance = 0.0);
+    void removeConnection(const string& hospitalId);
+    void clearConnections();
+    
+    // Point every text field at pool's copy of the same text
+    void reintern(StringPool& pool);
 
 public:
     // Constructors
     Hospital();
-    Hospital(const string& id, const string& name, 
-             const string& location, int patientCount);
+    Hospital(const char* id, const char* name, 
+             const char* location, int patientCount);
     
     // Getters
     string getId() const;
     string getName() const;
     string getLocation() const;
     int getPatientCount() const;
-    map<string, string> getConnections() const;
+    map<string, string> getConnections() const;     // Copy of ID -> description
+    const ConnectionList& getConnectionView() const; // No copy; invalidated by changes
     
-    // Setters
-    void setName(const string& name);
-    void setLocation(const string& location);
-    void setPatientCount(int count);
-    
-    // Connection management
-    void addConnection(const string& hospitalId, const string& description);
-    void removeConnection(const string& hospitalId);
-    void clearConnections();
+    // Connection lookup
     bool hasConnection(const string& hospitalId) const;
     string getConnectionDescription(const string& hospitalId) const;
+    double getConnectionDistance(const string& hospitalId) const;
     
     // Data validation
     static bool isValidId(const string& id);
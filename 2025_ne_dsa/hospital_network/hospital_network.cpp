@@ -1,11 +1,14 @@
 #include "hospital_network.h"
+#include "network_snapshot.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <queue>
 #include <set>
-#include <functional>
+#include <filesystem>
+#include <atomic>
+#include <thread>
 
 using namespace std;
 
@@ -17,11 +20,14 @@ HospitalNetwork::HospitalNetwork() {
 // Destructor
 HospitalNetwork::~HospitalNetwork() {
     saveData();
+    journal.close();
 }
 
 // CRUD Operations
 bool HospitalNetwork::addHospital(const string& id, const string& name, 
                                 const string& location, int patientCount) {
+    MetricTimer timer(*metrics, MetricOp::AddHospital);
+    lock_guard<recursive_mutex> lock(writeMutex);
     if (!Hospital::isValidId(id)) {
         cout << "Error: Invalid hospital ID format. Must start with 'H' followed by numbers.\n";
         return false;
@@ -37,13 +43,24 @@ bool HospitalNetwork::addHospital(const string& id, const string& name,
         return false;
     }
     
-    hospitals[id] = Hospital(id, name, location, patientCount);
+    insertHospital(id, name, location, patientCount);
+    
+    JournalRecord record;
+    record.op = JournalOp::AddHospital;
+    record.id = id;
+    record.name = name;
+    record.location = location;
+    record.patientCount = patientCount;
+    logChange(record);
+    commitChange();
     cout << "Hospital added successfully!\n";
     return true;
 }
 
 bool HospitalNetwork::updateHospital(const string& id, const string& name, 
                                    const string& location, int patientCount) {
+    MetricTimer timer(*metrics, MetricOp::UpdateHospital);
+    lock_guard<recursive_mutex> lock(writeMutex);
     if (!hospitalExists(id)) {
         cout << "Error: Hospital ID not found.\n";
         return false;
@@ -54,32 +71,222 @@ bool HospitalNetwork::updateHospital(const string& id, const string& name,
         return false;
     }
     
-    hospitals[id].setName(name);
-    hospitals[id].setLocation(location);
-    hospitals[id].setPatientCount(patientCount);
+    modifyHospital(id, name, location, patientCount);
+    
+    JournalRecord record;
+    record.op = JournalOp::UpdateHospital;
+    record.id = id;
+    record.name = name;
+    record.location = location;
+    record.patientCount = patientCount;
+    logChange(record);
+    commitChange();
     cout << "Hospital updated successfully!\n";
     return true;
 }
 
+// Change only the patient load, e.g. on admission or discharge. Text is
+// left alone (nothing is interned) and no new view is published: the
+// load index is shared with the published view and patched in place.
+// Inside a batch the patch waits for the outermost commit.
+bool HospitalNetwork::setPatientCount(const string& id, int patientCount) {
+    MetricTimer timer(*metrics, MetricOp::SetPatientCount);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    auto it = hospitals.find(id);
+    if (it == hospitals.end()) {
+        cout << "Error: Hospital ID not found.\n";
+        return false;
+    }
+    
+    if (!Hospital::isValidPatientCount(patientCount)) {
+        cout << "Error: Patient count must be non-negative.\n";
+        return false;
+    }
+    
+    it->second.setPatientCount(patientCount);
+    if (graphDirty) commitChange();     // The rebuild picks the count up
+    patchLoad(id, patientCount);
+    
+    // Journaled as a full update so the record format is unchanged
+    JournalRecord record;
+    record.op = JournalOp::UpdateHospital;
+    record.id = id;
+    record.name = it->second.getName();
+    record.location = it->second.getLocation();
+    record.patientCount = patientCount;
+    logChange(record);
+    cout << "Patient count updated successfully!\n";
+    return true;
+}
+
 bool HospitalNetwork::deleteHospital(const string& id) {
+    MetricTimer timer(*metrics, MetricOp::DeleteHospital);
+    lock_guard<recursive_mutex> lock(writeMutex);
     if (!hospitalExists(id)) {
         cout << "Error: Hospital ID not found.\n";
         return false;
     }
     
-    // Remove all connections involving this hospital
-    for (auto& pair : hospitals) {
-        if (pair.second.hasConnection(id)) {
-            pair.second.removeConnection(id);
-        }
-    }
+    eraseHospital(id);
     
-    hospitals.erase(id);
+    JournalRecord record;
+    record.op = JournalOp::DeleteHospital;
+    record.id = id;
+    logChange(record);
+    commitChange();
     cout << "Hospital deleted successfully!\n";
     return true;
 }
 
-Hospital* HospitalNetwork::getHospital(const string& id) {
+// Decommission several hospitals at once. Connections among the deleted
+// hospitals are skipped, and the graph version is bumped only once.
+size_t HospitalNetwork::deleteHospitals(const vector<string>& ids) {
+    MetricTimer timer(*metrics, MetricOp::DeleteHospitals);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    set<string> doomed;
+    for (const auto& id : ids) {
+        if (hospitalExists(id)) {
+            doomed.insert(id);
+        } else {
+            cout << "Error: Hospital ID " << id << " not found.\n";
+        }
+    }
+    
+    for (const auto& id : doomed) {
+        detachHospital(id, &doomed);
+    }
+    for (const auto& id : doomed) {
+        hospitals.erase(id);
+    }
+    if (!doomed.empty()) bumpGraphVersion();
+    
+    // Journal only once every delete is applied: logging may compact the
+    // journal into a snapshot of the live map, which must not still hold
+    // hospitals whose delete records the compaction throws away
+    for (const auto& id : doomed) {
+        JournalRecord record;
+        record.op = JournalOp::DeleteHospital;
+        record.id = id;
+        logChange(record);
+    }
+    commitChange();
+    cout << doomed.size() << " hospital(s) deleted successfully!\n";
+    return doomed.size();
+}
+
+// Writer batches nest; their changes are committed when the outermost
+// commits. Earlier commits are published first, so readers (including
+// this thread) keep seeing exactly the pre-batch state until then.
+void HospitalNetwork::beginBatch() {
+    writeMutex.lock();
+    if (batchDepth++ == 0 && publishPending) {
+        publish();
+    }
+}
+
+void HospitalNetwork::commitBatch() {
+    MetricTimer timer(*metrics, MetricOp::CommitBatch);
+    if (--batchDepth == 0) {
+        applyPendingLoads();
+        if (viewStale) {
+            viewStale = false;
+            publishPending = true;
+        }
+    }
+    writeMutex.unlock();
+}
+
+// Published views share the load index, so a patch is only applied once
+// it is committed: at once outside a batch, at the outermost commit inside
+// one. A dirty graph needs nothing, since the rebuild reads the hospitals.
+void HospitalNetwork::patchLoad(const string& id, int patientCount) {
+    if (graphDirty) return;
+    if (batchDepth > 0) {
+        pendingLoads.push_back(id);
+    } else {
+        graph.setPatientCount(graph.indexOf(id), patientCount);
+    }
+}
+
+void HospitalNetwork::applyPendingLoads() {
+    if (!graphDirty) {
+        for (const auto& id : pendingLoads) {
+            auto it = hospitals.find(id);
+            if (it != hospitals.end()) {
+                graph.setPatientCount(graph.indexOf(id), it->second.getPatientCount());
+            }
+        }
+    }
+    pendingLoads.clear();
+}
+
+// Publish committed changes on demand. Only one thread builds the view;
+// others wait for it (or for the writer holding the lock) instead of
+// returning a view that misses a change committed before this call.
+// Waiting never spans a batch: beginBatch clears publishPending.
+shared_ptr<const NetworkView> HospitalNetwork::view() const {
+    while (publishPending) {
+        unique_lock<recursive_mutex> lock(writeMutex, try_to_lock);
+        if (lock.owns_lock()) {
+            // The network itself is never const; only the view is
+            if (publishPending) const_cast<HospitalNetwork*>(this)->publish();
+            break;
+        }
+        this_thread::yield();
+    }
+    return atomic_load(&published);
+}
+
+// Versions come from one process-wide counter, so a thread-local path
+// cache never mistakes one network's view for another's
+void HospitalNetwork::bumpGraphVersion() {
+    static atomic<unsigned long long> versionCounter(0);
+    graphVersion = ++versionCounter;
+    hierarchy.reset();
+}
+
+void HospitalNetwork::commitChange() {
+    if (batchDepth == 0) {
+        publishPending = true;
+    } else {
+        viewStale = true;
+    }
+}
+
+// Copy the live state into a new view and swap it in. Readers still on
+// the old view keep it alive until they drop their pointer.
+void HospitalNetwork::publish() {
+    const NetworkGraph& current = currentGraph();
+    auto next = make_shared<const NetworkView>(hospitals, strings, current,
+                                               connectivity.label(current),
+                                               graphVersion, metrics, hierarchy);
+    atomic_store(&published, shared_ptr<const NetworkView>(move(next)));
+    viewStale = false;
+    publishPending = false;
+}
+
+// Remove every connection to a hospital. Connections are always stored on
+// both ends, so the hospital's own list is its incoming-edge index and
+// only real neighbours are visited: O(degree) instead of O(network).
+void HospitalNetwork::detachHospital(const string& id, const set<string>* skip) {
+    const ConnectionList& connections = hospitals[id].getConnectionView();
+    for (const auto& conn : connections) {
+        // A self-connection goes with the hospital; removing it here would
+        // change the list being walked
+        if (conn.first == id || (skip && skip->count(conn.first))) continue;
+        auto neighbour = hospitals.find(conn.first);
+        if (neighbour != hospitals.end()) {
+            neighbour->second.removeConnection(id);
+        }
+    }
+    
+    if (!graphDirty) {
+        graph.removeVertex(graph.indexOf(id));
+    }
+    connectivity.invalidate();
+}
+
+const Hospital* HospitalNetwork::getHospital(const string& id) const {
     auto it = hospitals.find(id);
     return (it != hospitals.end()) ? &(it->second) : nullptr;
 }
@@ -87,37 +294,155 @@ Hospital* HospitalNetwork::getHospital(const string& id) {
 // Connection Management
 bool HospitalNetwork::addConnection(const string& id1, const string& id2, 
                                   const string& description, double distance) {
+    MetricTimer timer(*metrics, MetricOp::AddConnection);
+    lock_guard<recursive_mutex> lock(writeMutex);
     if (!hospitalExists(id1) || !hospitalExists(id2)) {
         cout << "Error: One or both hospitals do not exist.\n";
         return false;
     }
     
-    // Add connection to both hospitals
-    hospitals[id1].addConnection(id2, description);
-    hospitals[id2].addConnection(id1, description);
+    linkHospitals(id1, id2, description, distance);
     
-    // Store distance
-    distances[make_pair(id1, id2)] = distance;
-    distances[make_pair(id2, id1)] = distance;
+    JournalRecord record;
+    record.op = JournalOp::AddConnection;
+    record.id = id1;
+    record.otherId = id2;
+    record.description = description;
+    record.distance = distance;
+    logChange(record);
+    commitChange();
     
     return true;
 }
 
 bool HospitalNetwork::removeConnection(const string& id1, const string& id2) {
+    MetricTimer timer(*metrics, MetricOp::RemoveConnection);
+    lock_guard<recursive_mutex> lock(writeMutex);
     if (!connectionExists(id1, id2)) {
         cout << "Error: Connection does not exist.\n";
         return false;
     }
     
+    unlinkHospitals(id1, id2);
+    
+    JournalRecord record;
+    record.op = JournalOp::RemoveConnection;
+    record.id = id1;
+    record.otherId = id2;
+    logChange(record);
+    commitChange();
+    cout << "Connection removed successfully!\n";
+    return true;
+}
+
+// Silent state changes shared by the public mutators and journal replay.
+// They check their own preconditions (a replayed record may no longer
+// apply) and neither print, journal nor publish.
+bool HospitalNetwork::insertHospital(const string& id, const string& name,
+                                     const string& location, int patientCount) {
+    if (!Hospital::isValidId(id) || hospitalExists(id) ||
+        !Hospital::isValidPatientCount(patientCount)) {
+        return false;
+    }
+    
+    hospitals[id] = Hospital(strings->intern(id), strings->intern(name),
+                             strings->intern(location), patientCount);
+    if (!graphDirty) graph.addVertex(id, patientCount);
+    connectivity.addHospital(id);
+    return true;
+}
+
+bool HospitalNetwork::modifyHospital(const string& id, const string& name,
+                                     const string& location, int patientCount) {
+    auto it = hospitals.find(id);
+    if (it == hospitals.end() || !Hospital::isValidPatientCount(patientCount)) return false;
+    
+    it->second.setName(strings->intern(name));
+    it->second.setLocation(strings->intern(location));
+    it->second.setPatientCount(patientCount);
+    patchLoad(id, patientCount);
+    return true;
+}
+
+bool HospitalNetwork::eraseHospital(const string& id) {
+    if (!hospitalExists(id)) return false;
+    
+    detachHospital(id);
+    hospitals.erase(id);
+    bumpGraphVersion();
+    return true;
+}
+
+bool HospitalNetwork::linkHospitals(const string& id1, const string& id2,
+                                    const string& description, double distance) {
+    if (!hospitalExists(id1) || !hospitalExists(id2)) return false;
+    
+    // An existing edge only needs its weight patched in the CSR, and a new
+    // one usually fits a free slot; a full row waits for the rebuild
+    if (!graphDirty) {
+        int u = graph.indexOf(id1);
+        int v = graph.indexOf(id2);
+        bool patched = connectionExists(id1, id2)
+            ? graph.setWeight(u, v, distance) && graph.setWeight(v, u, distance)
+            : graph.addEdge(u, v, distance) && (u == v || graph.addEdge(v, u, distance));
+        if (!patched) graphDirty = true;
+    }
+    
+    bumpGraphVersion();
+    
+    // Add connection (with its distance) to both hospitals
+    const char* text = strings->intern(description);
+    hospitals[id1].addConnection(strings->intern(id2), text, distance);
+    hospitals[id2].addConnection(strings->intern(id1), text, distance);
+    connectivity.connect(id1, id2);
+    return true;
+}
+
+bool HospitalNetwork::unlinkHospitals(const string& id1, const string& id2) {
+    if (!connectionExists(id1, id2)) return false;
+    
     // Remove bidirectional connection
     hospitals[id1].removeConnection(id2);
     hospitals[id2].removeConnection(id1);
-    cout << "Connection removed successfully!\n";
+    if (!graphDirty) {
+        int u = graph.indexOf(id1);
+        int v = graph.indexOf(id2);
+        graph.removeEdge(u, v);
+        graph.removeEdge(v, u);
+    }
+    connectivity.invalidate();
+    bumpGraphVersion();
+    return true;
+}
+
+bool HospitalNetwork::clearHospitals() {
+    if (hospitals.empty()) return false;
+    
+    // Clear all hospitals and their connections
+    hospitals.clear();
+    graphDirty = true;
+    connectivity.invalidate();
+    bumpGraphVersion();
+    return true;
+}
+
+bool HospitalNetwork::clearConnections() {
+    if (hospitals.empty()) return false;
+    
+    // Remove all connections (and their distances) from each hospital
+    for (auto& pair : hospitals) {
+        pair.second.clearConnections();
+    }
+    
+    graphDirty = true;
+    connectivity.invalidate();
+    bumpGraphVersion();
     return true;
 }
 
 // Display Methods
 void HospitalNetwork::displayAllHospitals() const {
+    MetricTimer timer(*metrics, MetricOp::DisplayAllHospitals);
     cout << "\n=== Hospital List ===\n";
     cout << left << setw(5) << "ID" << " | "
               << setw(20) << "Name" << " | "
@@ -125,21 +450,29 @@ void HospitalNetwork::displayAllHospitals() const {
               << setw(10) << "Patients" << "\n";
     cout << string(60, '-') << "\n";
     
-    for (const auto& pair : hospitals) {
-        cout << pair.second.toString() << "\n";
+    // Patient counts come from the live load index, not the view's copies
+    shared_ptr<const NetworkView> snapshot = view();
+    for (const auto& pair : snapshot->getHospitals()) {
+        const Hospital& hospital = pair.second;
+        cout << left << setw(5) << hospital.getId() << " | "
+             << setw(20) << hospital.getName() << " | "
+             << setw(20) << hospital.getLocation() << " | "
+             << setw(10) << snapshot->patientCount(pair.first) << "\n";
     }
 }
 
 void HospitalNetwork::displayConnections() const {
+    MetricTimer timer(*metrics, MetricOp::DisplayConnections);
     cout << "\n=== Hospital Connections ===\n";
     cout << left << setw(15) << "Hospital" << " | "
               << setw(30) << "Connected To" << " | "
               << setw(20) << "Description" << "\n";
     cout << string(70, '-') << "\n";
     
-    for (const auto& pair : hospitals) {
+    shared_ptr<const NetworkView> snapshot = view();
+    for (const auto& pair : snapshot->getHospitals()) {
         const Hospital& hospital = pair.second;
-        const auto& connections = hospital.getConnections();
+        const auto& connections = hospital.getConnectionView();
         
         if (connections.empty()) {
             cout << setw(15) << hospital.getId() << " | "
@@ -155,7 +488,7 @@ void HospitalNetwork::displayConnections() const {
                     cout << setw(15) << " " << " | ";
                 }
                 cout << setw(30) << conn.first << " | "
-                         << setw(20) << conn.second << "\n";
+                         << setw(20) << conn.second.description << "\n";
             }
         }
     }
@@ -173,6 +506,9 @@ bool HospitalNetwork::connectionExists(const string& id1, const string& id2) con
 
 // Predefined Scenario Setup
 void HospitalNetwork::setupPredefinedScenario() {
+    MetricTimer timer(*metrics, MetricOp::SetupScenario);
+    beginBatch();
+    
     // Add hospitals
     string hospitals[6] = {"H1", "H2", "H3", "H4", "H5", "H6"};
     for (const auto& id : hospitals) {
@@ -187,33 +523,11 @@ void HospitalNetwork::setupPredefinedScenario() {
     addConnection("H5", "H4", "Ambulance path", 50);
     addConnection("H4", "H1", "Referral support", 50);
     addConnection("H2", "H3", "Standard route", 75);
-}
-
-// File Operations
-bool HospitalNetwork::loadHospitals() {
-    ifstream file(HOSPITALS_FILE);
-    if (!file.is_open()) return false;
     
-    string line;
-    // Skip header
-    getline(file, line);
-    
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string id, name, location, patientCountStr;
-        
-        getline(ss, id, ',');
-        getline(ss, name, ',');
-        getline(ss, location, ',');
-        getline(ss, patientCountStr, ',');
-        
-        int patientCount = stoi(patientCountStr);
-        addHospital(id, name, location, patientCount);
-    }
-    
-    return true;
+    commitBatch();
 }
 
+// File Operations
 bool HospitalNetwork::saveHospitals() {
     ofstream file(HOSPITALS_FILE);
     if (!file.is_open()) return false;
@@ -229,45 +543,17 @@ bool HospitalNetwork::saveHospitals() {
     return true;
 }
 
-bool HospitalNetwork::loadConnections() {
-    ifstream file(GRAPH_FILE);
-    if (!file.is_open()) return false;
-    
-    string line;
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string hospitalId, connections;
-        
-        getline(ss, hospitalId, ',');
-        getline(ss, connections);
-        
-        stringstream connStream(connections);
-        string connection;
-        while (getline(connStream, connection, ',')) {
-            stringstream connSS(connection);
-            string connectedId, description;
-            
-            getline(connSS, connectedId, ':');
-            getline(connSS, description);
-            
-            addConnection(hospitalId, connectedId, description);
-        }
-    }
-    
-    return true;
-}
-
 bool HospitalNetwork::saveConnections() {
     ofstream file(GRAPH_FILE);
     if (!file.is_open()) return false;
     
     for (const auto& pair : hospitals) {
         const Hospital& hospital = pair.second;
-        const auto& connections = hospital.getConnections();
+        const auto& connections = hospital.getConnectionView();
         
         file << hospital.getId();
         for (const auto& conn : connections) {
-            file << "," << conn.first << ":" << conn.second;
+            file << "," << conn.first << ":" << conn.second.description;
         }
         file << "\n";
     }
@@ -275,7 +561,8 @@ bool HospitalNetwork::saveConnections() {
     return true;
 }
 
-void HospitalNetwork::exportRelationships() {
+void HospitalNetwork::exportRelationships() const {
+    MetricTimer timer(*metrics, MetricOp::ExportRelationships);
     ofstream file(RELATIONSHIPS_FILE);
     if (!file.is_open()) return;
     
@@ -283,9 +570,10 @@ void HospitalNetwork::exportRelationships() {
     file << "Hospital Center,Connected Hospitals,Description\n";
     
     // Write data
-    for (const auto& pair : hospitals) {
+    shared_ptr<const NetworkView> snapshot = view();
+    for (const auto& pair : snapshot->getHospitals()) {
         const Hospital& hospital = pair.second;
-        const auto& connections = hospital.getConnections();
+        const auto& connections = hospital.getConnectionView();
         
         if (connections.empty()) {
             file << hospital.getId() << ",None,N/A\n";
@@ -293,205 +581,511 @@ void HospitalNetwork::exportRelationships() {
             for (const auto& conn : connections) {
                 file << hospital.getId() << ","
                      << conn.first << ","
-                     << conn.second << "\n";
+                     << conn.second.description << "\n";
             }
         }
     }
 }
 
+// The binary snapshot is used when it is at least as new as both CSV
+// files; otherwise the CSV files were edited by hand and are imported.
+// Changes journaled since the last full save are then replayed on top.
 bool HospitalNetwork::loadData() {
-    return loadHospitals() && loadConnections();
+    MetricTimer timer(*metrics, MetricOp::LoadData);
+    beginBatch();
+    journaling = false;
+    
+    error_code ec;
+    auto snapshotTime = filesystem::last_write_time(SNAPSHOT_FILE, ec);
+    bool useSnapshot = !ec;
+    for (const string& csv : {HOSPITALS_FILE, GRAPH_FILE}) {
+        auto csvTime = filesystem::last_write_time(csv, ec);
+        if (!ec && useSnapshot && csvTime > snapshotTime) useSnapshot = false;
+    }
+    
+    bool loaded = useSnapshot && loadSnapshot(SNAPSHOT_FILE);
+    if (!loaded) {
+        BulkLoadReport report;
+        loaded = importCSV(HOSPITALS_FILE, GRAPH_FILE, report);
+        if (report.hospitalsLoaded > 0 || report.rowsRejected > 0) {
+            cout << report.summary() << "\n";
+        }
+    }
+    
+    uint64_t validLength = NetworkJournal::replay(JOURNAL_FILE,
+        [this](const JournalRecord& record) { applyJournalRecord(record); });
+    journal.open(JOURNAL_FILE, validLength);
+    journaling = true;
+    
+    // A saved hierarchy is only used if it was built on exactly this graph
+    ContractionHierarchy saved;
+    if (saved.load(HIERARCHY_FILE) && saved.matches(currentGraph())) {
+        hierarchy = make_shared<const ContractionHierarchy>(move(saved));
+    }
+    
+    publish();    // Readers always find a view, even when nothing was loaded
+    commitBatch();
+    return loaded;
 }
 
+// CSV files are written first so the snapshot ends up the newest file.
+// A full save makes the journal redundant, so it is emptied.
 bool HospitalNetwork::saveData() {
-    return saveHospitals() && saveConnections();
+    MetricTimer timer(*metrics, MetricOp::SaveData);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    if (!(saveHospitals() && saveConnections() && saveSnapshot(SNAPSHOT_FILE))) {
+        return false;
+    }
+    repackStrings();
+    if (hierarchy) {
+        if (!hierarchy->save(HIERARCHY_FILE)) return false;
+    } else {
+        error_code ec;
+        filesystem::remove(HIERARCHY_FILE, ec);    // Stale after any connection change
+    }
+    return journal.reset();
+}
+
+// Fold the journal into a fresh snapshot (CSV files are left as they are)
+bool HospitalNetwork::compactJournal() {
+    MetricTimer timer(*metrics, MetricOp::CompactJournal);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    if (!saveSnapshot(SNAPSHOT_FILE)) return false;
+    repackStrings();
+    return journal.reset();
 }
 
-vector<string> HospitalNetwork::findShortestPath(const string& start, const string& end) {
-    if (!hospitalExists(start) || !hospitalExists(end)) {
-        return vector<string>();
+// Move the live hospitals' text into a new pool, dropping strings that
+// updates and deletes left behind. Published views keep the old pool
+// alive for as long as they need it. Only done once the pool has doubled
+// since it was last packed, so the pass is amortized over the changes.
+void HospitalNetwork::repackStrings() {
+    if (strings->stringCount() < 2 * packedStringCount) return;
+    
+    auto fresh = make_shared<StringPool>();
+    for (auto& pair : hospitals) {
+        pair.second.reintern(*fresh);
     }
+    strings = fresh;
+    packedStringCount = strings->stringCount();
+}
+
+bool HospitalNetwork::syncJournal() {
+    MetricTimer timer(*metrics, MetricOp::SyncJournal);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    return journal.flush();
+}
+
+void HospitalNetwork::setJournalSyncPolicy(const JournalSyncPolicy& policy) {
+    lock_guard<recursive_mutex> lock(writeMutex);
+    journal.setSyncPolicy(policy);
+}
+
+JournalSyncPolicy HospitalNetwork::getJournalSyncPolicy() const {
+    lock_guard<recursive_mutex> lock(writeMutex);
+    return journal.getSyncPolicy();
+}
+
+void HospitalNetwork::logChange(const JournalRecord& record) {
+    if (!journaling) return;
     
-    map<string, double> dist;
-    map<string, string> prev;
-    priority_queue<pair<double, string>, vector<pair<double, string>>, 
-                  greater<pair<double, string>>> pq;
+    journal.append(record);
+    if (journal.size() > JOURNAL_COMPACT_BYTES) {
+        compactJournal();
+    }
+}
+
+// Replay goes through the silent helpers, so startup prints nothing per
+// record; records that no longer apply are skipped
+void HospitalNetwork::applyJournalRecord(const JournalRecord& record) {
+    switch (record.op) {
+        case JournalOp::AddHospital:
+            insertHospital(record.id, record.name, record.location, record.patientCount);
+            break;
+        case JournalOp::UpdateHospital:
+            modifyHospital(record.id, record.name, record.location, record.patientCount);
+            break;
+        case JournalOp::DeleteHospital:
+            eraseHospital(record.id);
+            break;
+        case JournalOp::AddConnection:
+            linkHospitals(record.id, record.otherId, record.description, record.distance);
+            break;
+        case JournalOp::RemoveConnection:
+            unlinkHospitals(record.id, record.otherId);
+            break;
+        case JournalOp::DeleteAllHospitals:
+            clearHospitals();
+            break;
+        case JournalOp::DeleteAllConnections:
+            clearConnections();
+            break;
+    }
+}
+
+// Bulk import: files are parsed in parallel chunks and validated in one
+// pass, then hospitals go into the map in sorted order. Bad rows are
+// collected in the report instead of printed one by one.
+bool HospitalNetwork::importCSV(const string& hospitalsFile, const string& graphFile,
+                                BulkLoadReport& report) {
+    MetricTimer timer(*metrics, MetricOp::ImportCSV);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    vector<ParsedHospital> parsedHospitals;
+    if (!BulkLoader::parseHospitals(hospitalsFile, parsedHospitals, report)) {
+        return false;
+    }
     
-    // Initialize distances
-    for (const auto& hospital : hospitals) {
-        dist[hospital.first] = numeric_limits<double>::infinity();
+    bool appendOnly = hospitals.empty();
+    for (auto& row : parsedHospitals) {
+        if (!appendOnly && hospitalExists(row.id)) {
+            report.reject(hospitalsFile, row.line, "hospital ID '" + row.id + "' already exists");
+            continue;
+        }
+        auto hint = appendOnly ? hospitals.end() : hospitals.lower_bound(row.id);
+        hospitals.emplace_hint(hint, row.id,
+                               Hospital(strings->intern(row.id), strings->intern(row.name),
+                                        strings->intern(row.location), row.patientCount));
+        report.hospitalsLoaded++;
     }
-    dist[start] = 0;
-    pq.push({0, start});
     
-    while (!pq.empty()) {
-        string current = pq.top().second;
-        pq.pop();
-        
-        if (current == end) break;
-        
-        for (const auto& connection : hospitals[current].getConnections()) {
-            string neighbor = connection.first;
-            double weight = distances[make_pair(current, neighbor)];
-            
-            if (dist[current] + weight < dist[neighbor]) {
-                dist[neighbor] = dist[current] + weight;
-                prev[neighbor] = current;
-                pq.push({dist[neighbor], neighbor});
-            }
+    vector<ParsedConnection> parsedConnections;
+    bool connectionsRead = BulkLoader::parseConnections(graphFile, parsedConnections, report);
+    for (const auto& row : parsedConnections) {
+        auto from = hospitals.find(row.from);
+        auto to = hospitals.find(row.to);
+        if (from == hospitals.end() || to == hospitals.end()) {
+            report.reject(graphFile, row.line,
+                          "connection " + row.from + " - " + row.to + " names an unknown hospital");
+            continue;
         }
+        
+        // graph.txt lists each connection from both ends; count it once
+        if (!from->second.hasConnection(row.to)) report.connectionsLoaded++;
+        const char* description = strings->intern(row.description);
+        from->second.addConnection(strings->intern(row.to), description);
+        to->second.addConnection(strings->intern(row.from), description);
     }
     
-    // Reconstruct path
-    vector<string> path;
-    for (string at = end; at != ""; at = prev[at]) {
-        path.push_back(at);
+    graphDirty = true;
+    connectivity.invalidate();
+    bumpGraphVersion();
+    
+    // Fold an import done at runtime straight into the snapshot
+    if (journaling) {
+        compactJournal();
     }
-    reverse(path.begin(), path.end());
-    return path;
+    commitChange();
+    return connectionsRead;
 }
 
-vector<string> HospitalNetwork::findLongestPath(const string& start, const string& end) {
-    if (!hospitalExists(start) || !hospitalExists(end)) {
-        return vector<string>();
-    }
+bool HospitalNetwork::loadSnapshot(const string& filename) {
+    MetricTimer timer(*metrics, MetricOp::LoadSnapshot);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    NetworkSnapshot snapshot;
+    if (!snapshot.open(filename)) return false;
     
-    // Use DFS to find all possible paths
-    vector<string> currentPath;
-    vector<string> longestPath;
-    set<string> visited;
+    hospitals.clear();
     
-    function<void(const string&)> dfs = [&](const string& current) {
-        if (current == end) {
-            if (currentPath.size() > longestPath.size()) {
-                longestPath = currentPath;
-            }
-            return;
-        }
-        
-        visited.insert(current);
-        for (const auto& connection : hospitals[current].getConnections()) {
-            string neighbor = connection.first;
-            if (visited.find(neighbor) == visited.end()) {
-                currentPath.push_back(neighbor);
-                dfs(neighbor);
-                currentPath.pop_back();
-            }
+    // Records are sorted by ID, so each insert lands at the end of the map
+    vector<Hospital*> byIndex;
+    vector<const char*> idByIndex;
+    byIndex.reserve(snapshot.getHospitalCount());
+    idByIndex.reserve(snapshot.getHospitalCount());
+    for (uint32_t i = 0; i < snapshot.getHospitalCount(); i++) {
+        const SnapshotHospital& record = snapshot.getHospital(i);
+        const char* id = strings->intern(snapshot.text(record.id));
+        auto it = hospitals.emplace_hint(hospitals.end(), id,
+            Hospital(id, strings->intern(snapshot.text(record.name)),
+                     strings->intern(snapshot.text(record.location)), record.patientCount));
+        byIndex.push_back(&it->second);
+        idByIndex.push_back(id);
+    }
+    
+    // Edges are stored in ID order too, so each connection is appended
+    for (uint32_t i = 0; i < snapshot.getHospitalCount(); i++) {
+        for (uint32_t e = snapshot.edgeBegin(i); e < snapshot.edgeEnd(i); e++) {
+            const SnapshotEdge& edge = snapshot.getEdge(e);
+            byIndex[i]->addConnection(idByIndex[edge.target],
+                                      strings->intern(snapshot.text(edge.description)),
+                                      edge.distance);
         }
-        visited.erase(current);
-    };
+    }
     
-    currentPath.push_back(start);
-    dfs(start);
-    return longestPath;
+    graph.rebuild(snapshot);
+    graphDirty = false;
+    connectivity.invalidate();
+    bumpGraphVersion();
+    commitChange();
+    return true;
+}
+
+bool HospitalNetwork::saveSnapshot(const string& filename) const {
+    MetricTimer timer(*metrics, MetricOp::SaveSnapshot);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    return NetworkSnapshot::write(filename, hospitals);
+}
+
+const NetworkGraph& HospitalNetwork::currentGraph() {
+    // Rebuild once tombstoned edges make up half of the CSR
+    if (graphDirty || graph.wastedSlotCount() * 2 > (int)graph.getTargets().size()) {
+        graph.rebuild(hospitals);
+        graphDirty = false;
+    }
+    return graph;
 }
 
-void HospitalNetwork::displayShortestPath(const string& start, const string& end) {
-    vector<string> path = findShortestPath(start, end);
+void HospitalNetwork::displayShortestPath(const string& start, const string& end) const {
+    MetricTimer timer(*metrics, MetricOp::DisplayShortestPath);
+    shared_ptr<const NetworkView> snapshot = view();
+    vector<string> path = snapshot->shortestPath(start, end);
     if (path.empty()) {
         cout << "No path found between " << start << " and " << end << "\n";
         return;
     }
     
     cout << "Shortest path from " << start << " to " << end << ":\n";
-    double totalDistance = 0;
     for (size_t i = 0; i < path.size() - 1; i++) {
         cout << path[i] << " -> ";
-        totalDistance += distances[make_pair(path[i], path[i + 1])];
     }
     cout << path.back() << "\n";
-    cout << "Total distance: " << totalDistance << " units\n";
+    cout << "Total distance: " << snapshot->pathDistance(path) << " units\n";
 }
 
-void HospitalNetwork::displayLongestPath(const string& start, const string& end) {
-    vector<string> path = findLongestPath(start, end);
+void HospitalNetwork::displayLongestPath(const string& start, const string& end,
+                                         const SearchBudget& budget) const {
+    MetricTimer timer(*metrics, MetricOp::DisplayLongestPath);
+    shared_ptr<const NetworkView> snapshot = view();
+    bool complete = true;
+    vector<string> path = snapshot->longestPath(start, end, budget, complete);
     if (path.empty()) {
-        cout << "No path found between " << start << " and " << end << "\n";
+        cout << "No path found between " << start << " and " << end;
+        cout << (complete ? "\n" : " within the search budget\n");
         return;
     }
     
+    if (!complete) {
+        cout << "Search budget reached; showing the longest path found so far.\n";
+    }
     cout << "Longest path from " << start << " to " << end << ":\n";
-    double totalDistance = 0;
     for (size_t i = 0; i < path.size() - 1; i++) {
         cout << path[i] << " -> ";
-        totalDistance += distances[make_pair(path[i], path[i + 1])];
     }
     cout << path.back() << "\n";
-    cout << "Total distance: " << totalDistance << " units\n";
+    cout << "Total distance: " << snapshot->pathDistance(path) << " units\n";
+}
+
+// Overflow routing: where to send patients from an overloaded hospital
+void HospitalNetwork::displayNearestWithCapacity(const string& origin, int k,
+                                                 int threshold) const {
+    MetricTimer timer(*metrics, MetricOp::DisplayNearestWithCapacity);
+    shared_ptr<const NetworkView> snapshot = view();
+    if (!snapshot->hospitalExists(origin)) {
+        cout << "Error: Hospital ID not found.\n";
+        return;
+    }
+    
+    vector<NearbyHospital> nearby = snapshot->nearestWithCapacity(origin, k, threshold);
+    if (nearby.empty()) {
+        cout << "No reachable hospital has fewer than " << threshold << " patients.\n";
+        return;
+    }
+    
+    cout << "\nNearest hospitals to " << origin << " with fewer than "
+         << threshold << " patients:\n";
+    cout << left << setw(10) << "ID" << " | " << setw(12) << "Distance"
+         << " | " << setw(10) << "Patients" << "\n";
+    cout << string(38, '-') << "\n";
+    for (const auto& hospital : nearby) {
+        cout << setw(10) << hospital.id << " | " << setw(12) << hospital.distance
+             << " | " << setw(10) << hospital.patientCount << "\n";
+    }
+}
+
+// Groups of hospitals that can reach each other, largest first
+void HospitalNetwork::displayComponents() const {
+    MetricTimer timer(*metrics, MetricOp::DisplayComponents);
+    shared_ptr<const NetworkView> snapshot = view();
+    const NetworkComponents& components = snapshot->getComponents();
+    if (components.count() == 0) {
+        cout << "No hospitals in the network.\n";
+        return;
+    }
+    
+    vector<int> order(components.count());
+    for (int c = 0; c < components.count(); c++) order[c] = c;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return components.offsets[a + 1] - components.offsets[a] >
+               components.offsets[b + 1] - components.offsets[b];
+    });
+    
+    cout << "\n=== Connected Groups (" << components.count() << ") ===\n";
+    for (size_t i = 0; i < order.size(); i++) {
+        int c = order[i];
+        int first = components.members[components.offsets[c]];
+        vector<string> members = snapshot->componentMembers(snapshot->getGraph().idOf(first));
+        cout << "Group " << (i + 1) << " (" << members.size() << " hospitals): ";
+        for (size_t m = 0; m < members.size(); m++) {
+            cout << (m ? ", " : "") << members[m];
+        }
+        cout << "\n";
+    }
+}
+
+void HospitalNetwork::displayConnectivity(const string& id1, const string& id2) const {
+    MetricTimer timer(*metrics, MetricOp::DisplayConnectivity);
+    shared_ptr<const NetworkView> snapshot = view();
+    if (!snapshot->hospitalExists(id1) || !snapshot->hospitalExists(id2)) {
+        cout << "Error: One or both hospitals do not exist.\n";
+        return;
+    }
+    
+    if (snapshot->connected(id1, id2)) {
+        cout << id1 << " can reach " << id2 << " ("
+             << snapshot->componentMembers(id1).size() << " hospitals in their group).\n";
+    } else {
+        cout << id1 << " cannot reach " << id2 << ": the network has "
+             << snapshot->componentCount() << " separate groups.\n";
+    }
+}
+
+DistanceMatrix HospitalNetwork::computeDistanceMatrix(const vector<string>& sourceIds,
+                                                      const vector<string>& targetIds,
+                                                      bool withPredecessors,
+                                                      unsigned threads) const {
+    MetricTimer timer(*metrics, MetricOp::DistanceMatrix);
+    DistanceMatrix matrix = DistanceMatrix::compute(view()->getGraph(), sourceIds, targetIds,
+                                                    withPredecessors, threads);
+    metrics->addSearchWork(MetricOp::DistanceMatrix, matrix.verticesSettled, matrix.edgesRelaxed);
+    return matrix;
+}
+
+// The graph is rebuilt first so its vertex numbering matches a fresh load
+// and the saved hierarchy can be reused on the next start
+bool HospitalNetwork::buildContractionHierarchy() {
+    MetricTimer timer(*metrics, MetricOp::BuildHierarchy);
+    lock_guard<recursive_mutex> lock(writeMutex);
+    if (hospitals.empty()) {
+        cout << "Error: No hospitals in the network.\n";
+        return false;
+    }
+    
+    graphDirty = true;
+    bumpGraphVersion();
+    hierarchy = make_shared<const ContractionHierarchy>(
+        ContractionHierarchy::build(currentGraph()));
+    commitChange();
+    cout << "Routing hierarchy built: " << hierarchy->vertexCount() << " hospitals, "
+         << hierarchy->shortcutCount() << " shortcuts.\n";
+    return true;
+}
+
+bool HospitalNetwork::hasContractionHierarchy() const {
+    lock_guard<recursive_mutex> lock(writeMutex);
+    return hierarchy != nullptr;
+}
+
+const NetworkMetrics& HospitalNetwork::getMetrics() const {
+    return *metrics;
+}
+
+void HospitalNetwork::displayMetrics() const {
+    cout << "\n=== Performance Metrics ===\n";
+    metrics->print(cout);
+}
+
+bool HospitalNetwork::exportMetrics(const string& filename) const {
+    return metrics->exportJSON(filename);
+}
+
+void HospitalNetwork::resetMetrics() {
+    metrics->reset();
+}
+
+PathCacheStats HospitalNetwork::getPathCacheStats() const {
+    PathCacheStats stats = NetworkView::getThreadCacheStats();
+    stats.hits = (long long)metrics->getPathCacheHits();
+    stats.misses = (long long)metrics->getPathCacheMisses();
+    return stats;
+}
+
+void HospitalNetwork::resetPathCacheStats() {
+    NetworkView::resetThreadCacheStats();
+    metrics->resetPathCache();
 }
 
 void HospitalNetwork::displayDistances() const {
+    MetricTimer timer(*metrics, MetricOp::DisplayDistances);
     cout << "\nHospital Distances:\n";
     cout << string(60, '-') << "\n";
     cout << "From\tTo\tDistance\n";
     cout << string(60, '-') << "\n";
     
-    for (const auto& dist : distances) {
-        cout << dist.first.first << "\t" 
-             << dist.first.second << "\t" 
-             << dist.second << "\n";
+    shared_ptr<const NetworkView> snapshot = view();
+    for (const auto& pair : snapshot->getHospitals()) {
+        for (const auto& conn : pair.second.getConnectionView()) {
+            cout << pair.first << "\t" 
+                 << conn.first << "\t" 
+                 << conn.second.distance << "\n";
+        }
     }
 }
 
-void HospitalNetwork::generateGraphImage() {
-    ofstream dotFile("hospital_network.dot");
-    dotFile << "digraph HospitalNetwork {\n";
-    dotFile << "    node [shape=box, style=filled, color=lightblue];\n";
+// Lay out and draw the network in-process (no Graphviz needed)
+bool HospitalNetwork::generateGraphImage(const DiagramOptions& options) const {
+    shared_ptr<const NetworkView> snapshot = view();
+    const NetworkGraph& g = snapshot->getGraph();
     
-    // Add nodes (hospitals)
-    for (const auto& hospital : hospitals) {
-        dotFile << "    \"" << hospital.first << "\" [label=\"" 
-                << hospital.first << "\\n" << hospital.second.getName() << "\"];\n";
+    vector<string> labels;
+    labels.reserve(g.vertexCount());
+    for (int v = 0; v < g.vertexCount(); v++) {
+        const Hospital* hospital = snapshot->findHospital(g.idOf(v));
+        labels.push_back(hospital ? g.idOf(v) + " - " + hospital->getName() : g.idOf(v));
     }
     
-    // Add edges (connections)
-    for (const auto& hospital : hospitals) {
-        for (const auto& connection : hospital.second.getConnections()) {
-            dotFile << "    \"" << hospital.first << "\" -> \"" 
-                    << connection.first << "\" [label=\"" 
-                    << distances[make_pair(hospital.first, connection.first)] 
-                    << "\"];\n";
-        }
-    }
-    
-    dotFile << "}\n";
-    dotFile.close();
-    
-    // Generate image using Graphviz
-    system("dot -Tpng hospital_network.dot -o hospital_network.png");
+    return NetworkDiagram::renderSVG(g, labels, GRAPH_IMAGE_FILE, options);
 }
 
-void HospitalNetwork::generateNetworkDiagram() {
-    generateGraphImage();
-    cout << "Network diagram generated as 'hospital_network.png'\n";
+void HospitalNetwork::generateNetworkDiagram(const DiagramOptions& options) const {
+    MetricTimer timer(*metrics, MetricOp::GenerateDiagram);
+    if (generateGraphImage(options)) {
+        cout << "Network diagram generated as '" << GRAPH_IMAGE_FILE << "'\n";
+    } else {
+        cout << "Error: Could not write '" << GRAPH_IMAGE_FILE << "'\n";
+    }
 }
 
 bool HospitalNetwork::deleteAllHospitals() {
+    MetricTimer timer(*metrics, MetricOp::DeleteAllHospitals);
+    lock_guard<recursive_mutex> lock(writeMutex);
     if (hospitals.empty()) {
         cout << "No hospitals to delete.\n";
         return false;
     }
     
-    // Clear all hospitals and their connections
-    hospitals.clear();
-    distances.clear();
+    clearHospitals();
+    
+    JournalRecord record;
+    record.op = JournalOp::DeleteAllHospitals;
+    logChange(record);
+    commitChange();
     cout << "All hospitals and their connections have been deleted.\n";
     return true;
 }
 
 bool HospitalNetwork::deleteAllConnections() {
+    MetricTimer timer(*metrics, MetricOp::DeleteAllConnections);
+    lock_guard<recursive_mutex> lock(writeMutex);
     if (hospitals.empty()) {
         cout << "No hospitals exist to delete connections from.\n";
         return false;
     }
     
-    // Remove all connections from each hospital
-    for (auto& pair : hospitals) {
-        pair.second.clearConnections();
-    }
+    clearConnections();
     
-    // Clear the distances map
-    distances.clear();
+    JournalRecord record;
+    record.op = JournalOp::DeleteAllConnections;
+    logChange(record);
+    commitChange();
     cout << "All connections have been deleted.\n";
     return true;
 } 
\ No newline at end of file
@@ -12,39 +12,121 @@
 #define HOSPITAL_NETWORK_H
 
 #include "hospital.h"
+#include "network_graph.h"
+#include "longest_path.h"
+#include "path_cache.h"
+#include "distance_matrix.h"
+#include "network_journal.h"
+#include "bulk_loader.h"
+#include "network_diagram.h"
+#include "network_view.h"
+#include "network_metrics.h"
+#include "contraction_hierarchy.h"
+#include "connectivity_index.h"
+#include "string_pool.h"
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <fstream>
 #include <vector>
 #include <queue>
+#include <set>
 #include <limits>
 
 using namespace std;
 
 class HospitalNetwork {
 private:
-    // Map to store hospitals (key: hospital ID, value: Hospital object)
+    // Map to store hospitals (key: hospital ID, value: Hospital object).
+    // Their text lives in strings, which published views share so it
+    // stays valid for as long as any of them is in use. The pool only
+    // grows (an update interns its new text and keeps the old), so a
+    // compaction or full save swaps in a freshly packed one once it has
+    // doubled (repackStrings).
     map<string, Hospital> hospitals;
+    shared_ptr<StringPool> strings = make_shared<StringPool>();
+    size_t packedStringCount = 0;       // Pool size after the last repack
     
-    // Map to store distances between hospitals
-    map<pair<string, string>, double> distances;
+    // Integer-indexed CSR copy of the connections used by path queries.
+    // Cheap changes patch it in place; others mark it dirty so it is
+    // rebuilt on the next query.
+    NetworkGraph graph;
+    bool graphDirty = true;
+    
+    // Bumped by every change; cached shortest-path trees from an older
+    // version are discarded
+    unsigned long long graphVersion = 0;
+    
+    // Optional routing preprocessing for the current graph. Any change to
+    // the connections drops it (bumpGraphVersion) until it is rebuilt.
+    shared_ptr<const ContractionHierarchy> hierarchy;
+    
+    // Which hospitals can reach each other; labels are frozen into each view
+    ConnectivityIndex connectivity;
+    
+    // Queries run on an immutable view that is replaced (RCU style) once
+    // changes are committed. Building a view copies the network, so it is
+    // done lazily: a commit only sets publishPending, and the first view()
+    // after it publishes. Writers are serialized by writeMutex; changes
+    // inside a batch count as committed when the outermost batch commits.
+    shared_ptr<const NetworkView> published;
+    mutable recursive_mutex writeMutex;
+    int batchDepth = 0;
+    bool viewStale = false;             // Uncommitted changes in the open batch
+    atomic<bool> publishPending{false}; // Committed changes not yet in published
+    
+    // Latency and search-work counters, shared with every published view
+    shared_ptr<NetworkMetrics> metrics = make_shared<NetworkMetrics>();
     
     // File paths
     const string HOSPITALS_FILE = "hospitals.csv";
     const string GRAPH_FILE = "graph.txt";
     const string RELATIONSHIPS_FILE = "relationships.csv";
-    const string GRAPH_IMAGE_FILE = "hospital_network.png";
+    const string GRAPH_IMAGE_FILE = "hospital_network.svg";
+    const string SNAPSHOT_FILE = "network.snap";
+    const string JOURNAL_FILE = "network.journal";
+    const string HIERARCHY_FILE = "network.ch";
+    
+    // Changes since the last full save; folded into the snapshot once
+    // the journal grows past JOURNAL_COMPACT_BYTES
+    NetworkJournal journal;
+    bool journaling = false;
+    static const uint64_t JOURNAL_COMPACT_BYTES = 8 * 1024 * 1024;
     
     // Helper methods
-    bool loadHospitals();
     bool saveHospitals();
-    bool loadConnections();
     bool saveConnections();
+    void logChange(const JournalRecord& record);
+    void detachHospital(const string& id, const set<string>* skip = nullptr);
+    
+    // Silent state changes behind the public mutators, also used by replay
+    bool insertHospital(const string& id, const string& name,
+                        const string& location, int patientCount);
+    bool modifyHospital(const string& id, const string& name,
+                        const string& location, int patientCount);
+    bool eraseHospital(const string& id);
+    bool linkHospitals(const string& id1, const string& id2,
+                       const string& description, double distance);
+    bool unlinkHospitals(const string& id1, const string& id2);
+    bool clearHospitals();
+    bool clearConnections();
+    void applyJournalRecord(const JournalRecord& record);
+    void bumpGraphVersion();
+    void repackStrings();
+    void commitChange();
+    void publish();
+    
+    // Hospitals whose patient count changed in the open batch; their load
+    // index entries are patched when it commits
+    vector<string> pendingLoads;
+    void patchLoad(const string& id, int patientCount);
+    void applyPendingLoads();
     
     // Graph analysis helpers
-    vector<string> findShortestPath(const string& start, const string& end);
-    vector<string> findLongestPath(const string& start, const string& end);
-    void generateGraphImage();
+    const NetworkGraph& currentGraph();
+    bool generateGraphImage(const DiagramOptions& options) const;
     
 public:
     // Constructor and destructor
@@ -56,9 +138,20 @@ public:
                     const string& location, int patientCount);
     bool updateHospital(const string& id, const string& name, 
                        const string& location, int patientCount);
+    bool setPatientCount(const string& id, int patientCount);   // Needs no new view
     bool deleteHospital(const string& id);
+    size_t deleteHospitals(const vector<string>& ids);
     bool deleteAllHospitals();
-    Hospital* getHospital(const string& id);
+    const Hospital* getHospital(const string& id) const;   // Live state, read-only
+    
+    // Writer batches: changes between beginBatch and commitBatch are
+    // published to readers together. Both calls must come from one thread.
+    void beginBatch();
+    void commitBatch();
+    
+    // Read path: the latest committed view of the network. Lock-free once
+    // published; the first call after a commit builds the new view.
+    shared_ptr<const NetworkView> view() const;
     
     // Connection management
     bool addConnection(const string& id1, const string& id2, 
@@ -69,11 +162,40 @@ public:
     // Display methods
     void displayAllHospitals() const;
     void displayConnections() const;
-    void displayShortestPath(const string& start, const string& end);
-    void displayLongestPath(const string& start, const string& end);
+    void displayShortestPath(const string& start, const string& end) const;
+    void displayLongestPath(const string& start, const string& end,
+                            const SearchBudget& budget =
+                                SearchBudget{DEFAULT_LONGEST_PATH_BUDGET_MS, 0}) const;
     void displayDistances() const;
+    void displayNearestWithCapacity(const string& origin, int k, int threshold) const;
+    void displayComponents() const;
+    void displayConnectivity(const string& id1, const string& id2) const;
+    
+    // Batch shortest distances from every source to every target
+    DistanceMatrix computeDistanceMatrix(const vector<string>& sourceIds,
+                                         const vector<string>& targetIds,
+                                         bool withPredecessors = false,
+                                         unsigned threads = 0) const;
+    
+    // Contraction hierarchy for fast shortest paths on large networks.
+    // Saved and loaded with the rest of the data; discarded by any change
+    // to the connections.
+    bool buildContractionHierarchy();
+    bool hasContractionHierarchy() const;
+    
+    // Per-operation latency and search work (mutators, queries, display
+    // and file operations; cheap accessors are not timed)
+    const NetworkMetrics& getMetrics() const;
+    void displayMetrics() const;
+    bool exportMetrics(const string& filename) const;
+    void resetMetrics();
+    
+    // Shortest-path cache statistics: hits and misses from every thread,
+    // entries in the calling thread's cache
+    PathCacheStats getPathCacheStats() const;
+    void resetPathCacheStats();
     
-    // Validation methods
+    // Validation methods (live state, for writers; readers use view())
     bool hospitalExists(const string& id) const;
     bool connectionExists(const string& id1, const string& id2) const;
     
@@ -83,8 +205,16 @@ public:
     // File operations
     bool loadData();
     bool saveData();
-    void exportRelationships();
-    void generateNetworkDiagram();
+    bool importCSV(const string& hospitalsFile, const string& graphFile,
+                   BulkLoadReport& report);
+    bool loadSnapshot(const string& filename);
+    bool saveSnapshot(const string& filename) const;
+    bool compactJournal();
+    bool syncJournal();
+    void setJournalSyncPolicy(const JournalSyncPolicy& policy);
+    JournalSyncPolicy getJournalSyncPolicy() const;
+    void exportRelationships() const;
+    void generateNetworkDiagram(const DiagramOptions& options = DiagramOptions()) const;
 };
 
 #endif // HOSPITAL_NETWORK_H 
\ No newline at end of file
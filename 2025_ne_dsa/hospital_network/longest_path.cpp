@@ -0,0 +1,330 @@
+#include "longest_path.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+const int LongestPathSearch::SMALL_COMPONENT;
+const int LongestPathSearch::MEDIUM_COMPONENT;
+
+LongestPathSearch::LongestPathSearch(const NetworkGraph& graph, const SearchBudget& budget)
+    : graph(graph), budget(budget) {}
+
+LongestPathResult LongestPathSearch::find(int source, int target) {
+    LongestPathResult result;
+    int n = graph.vertexCount();
+    if (source < 0 || source >= n || target < 0 || target >= n) return result;
+
+    this->source = source;
+    this->target = target;
+    deadline = chrono::steady_clock::now() + chrono::milliseconds(budget.timeLimitMs);
+    bestLength = 0;
+    nodes = 0;
+    edges = 0;
+    stopped = false;
+    bestPath.clear();
+
+    if (source == target) {
+        result.path.push_back(source);
+        result.strategy = "trivial";
+        return result;
+    }
+
+    vector<int> component = componentOf(source);
+    if (std::find(component.begin(), component.end(), target) == component.end()) {
+        result.strategy = "unreachable";
+        return result;
+    }
+
+    if ((int)component.size() <= SMALL_COMPONENT) {
+        return bitmaskDp(component);
+    }
+
+    if ((int)component.size() <= MEDIUM_COMPONENT) {
+        Worker worker = makeWorker();
+        worker.path.push_back(source);
+        worker.visited[source] = 1;
+        branchAndBound(worker);
+        nodes += worker.localNodes;
+        edges += worker.localEdges;
+        result.strategy = "branch-and-bound";
+    } else {
+        runParallel();
+        result.strategy = "parallel";
+    }
+
+    result.path = bestPath;
+    result.complete = !stopped;
+    result.nodesExpanded = nodes;
+    result.edgesScanned = edges;
+    return result;
+}
+
+// Vertices reachable from vertex (connections are bidirectional)
+vector<int> LongestPathSearch::componentOf(int vertex) const {
+    const vector<int>& offsets = graph.getOffsets();
+    const vector<int>& targets = graph.getTargets();
+
+    vector<char> seen(graph.vertexCount(), 0);
+    vector<int> component;
+    component.push_back(vertex);
+    seen[vertex] = 1;
+    for (size_t i = 0; i < component.size(); i++) {
+        int current = component[i];
+        for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+            int neighbor = targets[e];
+            if (neighbor != NetworkGraph::NO_VERTEX && !seen[neighbor]) {
+                seen[neighbor] = 1;
+                component.push_back(neighbor);
+            }
+        }
+    }
+    return component;
+}
+
+// Small components: reach[mask] holds the vertices a simple path from
+// source can end at after visiting exactly the vertices in mask.
+LongestPathResult LongestPathSearch::bitmaskDp(const vector<int>& component) {
+    LongestPathResult result;
+    result.strategy = "bitmask-dp";
+
+    int k = (int)component.size();
+    int localSource = 0, localTarget = 0;
+    vector<int> local(graph.vertexCount(), -1);
+    for (int i = 0; i < k; i++) {
+        local[component[i]] = i;
+        if (component[i] == source) localSource = i;
+        if (component[i] == target) localTarget = i;
+    }
+
+    const vector<int>& offsets = graph.getOffsets();
+    const vector<int>& targets = graph.getTargets();
+    vector<uint32_t> adjacent(k, 0);
+    for (int i = 0; i < k; i++) {
+        int v = component[i];
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            if (targets[e] != NetworkGraph::NO_VERTEX && local[targets[e]] >= 0) {
+                adjacent[i] |= 1u << local[targets[e]];
+            }
+        }
+    }
+
+    uint32_t full = 1u << k;
+    uint32_t sourceBit = 1u << localSource;
+    uint32_t targetBit = 1u << localTarget;
+    vector<uint32_t> reach(full, 0);
+    reach[sourceBit] = sourceBit;
+
+    long long expanded = 0;
+    uint32_t mask = 0;
+    for (; mask < full; mask++) {
+        if (!(mask & sourceBit) || !reach[mask]) continue;
+        if ((++expanded & 0xfff) == 0 && limitReached(expanded)) break;
+
+        // Paths stop at the target, so only extend the other end points
+        for (uint32_t ends = reach[mask] & ~targetBit; ends; ends &= ends - 1) {
+            int v = __builtin_ctz(ends);
+            for (uint32_t next = adjacent[v] & ~mask; next; next &= next - 1) {
+                int u = __builtin_ctz(next);
+                result.edgesScanned++;
+                reach[mask | (1u << u)] |= 1u << u;
+            }
+        }
+    }
+
+    // Every mask below the stopping point is final
+    uint32_t best = 0;
+    int bestCount = 0;
+    for (uint32_t m = 0; m < mask; m++) {
+        if ((reach[m] & targetBit) && __builtin_popcount(m) > bestCount) {
+            best = m;
+            bestCount = __builtin_popcount(m);
+        }
+    }
+    result.complete = (mask == full);
+    result.nodesExpanded = expanded;
+    if (bestCount == 0) return result;
+
+    // Walk back from the target through predecessor masks
+    int current = localTarget;
+    while (true) {
+        result.path.push_back(component[current]);
+        if (current == localSource) break;
+        uint32_t previous = best ^ (1u << current);
+        uint32_t candidates = reach[previous] & adjacent[current] & ~targetBit;
+        current = __builtin_ctz(candidates);
+        best = previous;
+    }
+    reverse(result.path.begin(), result.path.end());
+    return result;
+}
+
+// Depth-first search that prunes any branch whose reachability bound
+// cannot beat the best path found so far. worker.path holds the prefix to
+// search below; it is restored to that prefix on return.
+void LongestPathSearch::branchAndBound(Worker& worker) {
+    const vector<int>& offsets = graph.getOffsets();
+    const vector<int>& targets = graph.getTargets();
+
+    worker.frames.clear();
+    if (enterVertex(worker)) {
+        int root = worker.path.back();
+        worker.frames.push_back({root, offsets[root]});
+    }
+
+    while (!worker.frames.empty()) {
+        Frame& frame = worker.frames.back();
+        int end = offsets[frame.vertex + 1];
+        while (frame.edge < end && (targets[frame.edge] == NetworkGraph::NO_VERTEX ||
+                                    worker.visited[targets[frame.edge]])) {
+            frame.edge++;
+        }
+
+        // Branch finished (or search stopped): back up to the parent
+        if (frame.edge == end || stopped) {
+            worker.frames.pop_back();
+            if (!worker.frames.empty()) {
+                worker.visited[worker.path.back()] = 0;
+                worker.path.pop_back();
+            }
+            continue;
+        }
+
+        int neighbor = targets[frame.edge++];
+        worker.localEdges++;
+        worker.visited[neighbor] = 1;
+        worker.path.push_back(neighbor);
+        if (enterVertex(worker)) {
+            worker.frames.push_back({neighbor, offsets[neighbor]});
+        } else {
+            worker.path.pop_back();
+            worker.visited[neighbor] = 0;
+        }
+    }
+}
+
+// Visit the last vertex of worker.path; true if its neighbours are worth
+// expanding
+bool LongestPathSearch::enterVertex(Worker& worker) {
+    if (stopped || budgetExhausted(worker)) return false;
+
+    int current = worker.path.back();
+    if (current == target) {
+        offerPath(worker.path);
+        return false;
+    }
+
+    int reachable = upperBound(worker, current);
+    return reachable >= 0 && (int)worker.path.size() + reachable > bestLength;
+}
+
+// Number of unvisited vertices still reachable from `from`, or -1 if the
+// target is no longer reachable
+int LongestPathSearch::upperBound(Worker& worker, int from) {
+    const vector<int>& offsets = graph.getOffsets();
+    const vector<int>& targets = graph.getTargets();
+
+    worker.stamp++;
+    worker.queue.clear();
+    worker.queue.push_back(from);
+    worker.seen[from] = worker.stamp;
+    bool targetFound = false;
+
+    for (size_t i = 0; i < worker.queue.size(); i++) {
+        int current = worker.queue[i];
+        for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+            int neighbor = targets[e];
+            if (neighbor == NetworkGraph::NO_VERTEX || worker.visited[neighbor] ||
+                worker.seen[neighbor] == worker.stamp) continue;
+
+            worker.seen[neighbor] = worker.stamp;
+            if (neighbor == target) {
+                targetFound = true;     // Path must end here, do not expand
+            } else {
+                worker.queue.push_back(neighbor);
+            }
+        }
+    }
+
+    if (!targetFound) return -1;
+    return (int)worker.queue.size();    // Queue minus `from`, plus the target
+}
+
+// Large components: expand the first levels breadth-first into prefixes
+// and let worker threads run branch-and-bound under each one
+void LongestPathSearch::runParallel() {
+    unsigned threadCount = max(1u, thread::hardware_concurrency());
+    const vector<int>& offsets = graph.getOffsets();
+    const vector<int>& targets = graph.getTargets();
+
+    vector<vector<int>> prefixes(1, vector<int>(1, source));
+    size_t wanted = (size_t)threadCount * 8;
+    for (int depth = 0; depth < 4 && prefixes.size() < wanted; depth++) {
+        vector<vector<int>> next;
+        for (const auto& prefix : prefixes) {
+            int last = prefix.back();
+            if (last == target) {
+                offerPath(prefix);
+                continue;
+            }
+            for (int e = offsets[last]; e < offsets[last + 1]; e++) {
+                int neighbor = targets[e];
+                if (neighbor == NetworkGraph::NO_VERTEX ||
+                    std::find(prefix.begin(), prefix.end(), neighbor) != prefix.end()) continue;
+                next.push_back(prefix);
+                next.back().push_back(neighbor);
+            }
+        }
+        prefixes.swap(next);
+    }
+
+    atomic<size_t> nextTask{0};
+    auto work = [&]() {
+        Worker worker = makeWorker();
+        size_t task;
+        while (!stopped && (task = nextTask++) < prefixes.size()) {
+            for (int v : prefixes[task]) worker.visited[v] = 1;
+            worker.path = prefixes[task];
+            branchAndBound(worker);
+            for (int v : prefixes[task]) worker.visited[v] = 0;
+        }
+        nodes += worker.localNodes;
+        edges += worker.localEdges;
+    };
+
+    vector<thread> threads;
+    unsigned spawned = min<size_t>(threadCount, prefixes.size());
+    for (unsigned i = 1; i < spawned; i++) threads.emplace_back(work);
+    work();
+    for (auto& t : threads) t.join();
+}
+
+bool LongestPathSearch::budgetExhausted(Worker& worker) {
+    worker.localNodes++;
+    if ((worker.localNodes & 0xff) != 0) return stopped;
+
+    long long total = nodes.fetch_add(0x100) + 0x100;
+    worker.localNodes -= 0x100;
+    return limitReached(total);
+}
+
+bool LongestPathSearch::limitReached(long long expanded) {
+    if (budget.nodeLimit > 0 && expanded >= budget.nodeLimit) stopped = true;
+    if (budget.timeLimitMs > 0 && chrono::steady_clock::now() >= deadline) stopped = true;
+    return stopped;
+}
+
+void LongestPathSearch::offerPath(const vector<int>& path) {
+    lock_guard<mutex> lock(bestMutex);
+    if ((int)path.size() > bestLength) {
+        bestPath = path;
+        bestLength = (int)path.size();
+    }
+}
+
+LongestPathSearch::Worker LongestPathSearch::makeWorker() const {
+    Worker worker;
+    worker.visited.assign(graph.vertexCount(), 0);
+    worker.seen.assign(graph.vertexCount(), 0);
+    return worker;
+}
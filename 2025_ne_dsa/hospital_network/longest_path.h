@@ -0,0 +1,98 @@
+/**
+ * Longest Path Search Header
+ *
+ * Finds the simple path with the most hospitals between two vertices of a
+ * NetworkGraph. The strategy is picked from the size of the start
+ * hospital's connected component:
+ * - Bitmask dynamic programming for small components
+ * - Branch-and-bound DFS with a reachability upper bound for medium ones
+ * - The same branch-and-bound split across worker threads for large ones
+ *
+ * Longest simple path is NP-hard, so callers can pass a time or node
+ * budget; when it runs out the best path found so far is returned.
+ */
+
+#ifndef LONGEST_PATH_H
+#define LONGEST_PATH_H
+
+#include "network_graph.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Time limit used when a caller does not pick one (menu, batch mode, API)
+static const long long DEFAULT_LONGEST_PATH_BUDGET_MS = 5000;
+
+// Limits for a search. Zero means unlimited.
+struct SearchBudget {
+    long long timeLimitMs = 0;      // Wall-clock limit in milliseconds
+    long long nodeLimit = 0;        // Maximum search nodes expanded
+};
+
+struct LongestPathResult {
+    vector<int> path;               // Vertex sequence, empty if none found
+    bool complete = true;           // False when the budget cut the search short
+    long long nodesExpanded = 0;
+    long long edgesScanned = 0;     // Extensions tried from expanded nodes
+    string strategy;                // "bitmask-dp", "branch-and-bound" or "parallel"
+};
+
+class LongestPathSearch {
+public:
+    static const int SMALL_COMPONENT = 20;     // Largest component for bitmask DP
+    static const int MEDIUM_COMPONENT = 64;    // Largest component searched on one thread
+
+    LongestPathSearch(const NetworkGraph& graph, const SearchBudget& budget);
+
+    LongestPathResult find(int source, int target);
+
+private:
+    const NetworkGraph& graph;
+    SearchBudget budget;
+    chrono::steady_clock::time_point deadline;
+    int source = NetworkGraph::NO_VERTEX;
+    int target = NetworkGraph::NO_VERTEX;
+
+    // State shared between branch-and-bound workers
+    atomic<int> bestLength{0};
+    atomic<long long> nodes{0};
+    atomic<long long> edges{0};
+    atomic<bool> stopped{false};
+    mutex bestMutex;
+    vector<int> bestPath;
+
+    // Per-worker scratch space. The search keeps its own stack of frames
+    // (vertex, next edge to try) so long paths cannot overflow the call stack.
+    struct Frame {
+        int vertex;
+        int edge;
+    };
+    struct Worker {
+        vector<int> path;
+        vector<Frame> frames;
+        vector<char> visited;
+        vector<int> seen;           // BFS stamp per vertex
+        vector<int> queue;
+        int stamp = 0;
+        long long localNodes = 0;
+        long long localEdges = 0;
+    };
+
+    vector<int> componentOf(int vertex) const;
+    LongestPathResult bitmaskDp(const vector<int>& component);
+    void branchAndBound(Worker& worker);
+    bool enterVertex(Worker& worker);
+    void runParallel();
+    int upperBound(Worker& worker, int from);
+    bool budgetExhausted(Worker& worker);
+    bool limitReached(long long expanded);
+    void offerPath(const vector<int>& path);
+    Worker makeWorker() const;
+};
+
+#endif // LONGEST_PATH_H
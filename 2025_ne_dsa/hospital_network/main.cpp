@@ -14,11 +14,23 @@
  * 
  * - limits: Standard C++ library for numeric limits
  *   Used for input validation and buffer management
+ *
+ * - batch_processor.h: Non-interactive command pipeline used by batch mode
+ *
+ * Usage:
+ *   hospital_network                       Interactive menu
+ *   hospital_network --batch FILE|-        Run commands from FILE (or stdin)
+ *       [--output FILE] [--transaction-size N] [--checkpoint-every N] [--echo]
  */
 
 #include "hospital_network.h"
+#include "batch_processor.h"
 #include <iostream>
+#include <fstream>
+#include <cerrno>
+#include <cstdlib>
 #include <limits>
+#include <string>
 
 using namespace std;
 
@@ -57,6 +69,11 @@ void displayMenu() {
    cout << "13. Generate Network Diagram\n";
    cout << "14. Delete All Hospitals\n";
    cout << "15. Delete All Connections\n";
+   cout << "16. Display Performance Metrics\n";
+   cout << "17. Find Nearest Hospitals With Capacity\n";
+   cout << "18. Build Routing Hierarchy\n";
+   cout << "19. Display Connected Groups\n";
+   cout << "20. Check If Two Hospitals Are Connected\n";
    cout << "0. Exit\n";
    cout << "Enter your choice: ";
 }
@@ -167,7 +184,39 @@ void handleLongestPath(HospitalNetwork& network) {
     cout << "Enter destination Hospital ID: ";
     getline(cin, end);
     
-    network.displayLongestPath(start, end);
+    // Large networks cannot be searched exhaustively, so cap the search
+    SearchBudget budget;
+    budget.timeLimitMs = DEFAULT_LONGEST_PATH_BUDGET_MS;
+    network.displayLongestPath(start, end, budget);
+}
+
+// Function to handle overflow routing to nearby hospitals with capacity
+void handleNearestWithCapacity(HospitalNetwork& network) {
+    string origin;
+    
+    cout << "\nEnter origin Hospital ID: ";
+    getline(cin, origin);
+    
+    cout << "How many hospitals to list: ";
+    int k = getIntInput();
+    
+    cout << "Only hospitals with fewer patients than: ";
+    int threshold = getIntInput();
+    
+    network.displayNearestWithCapacity(origin, k, threshold);
+}
+
+// Function to check whether two hospitals can reach each other
+void handleConnectivity(HospitalNetwork& network) {
+    string id1, id2;
+    
+    cout << "\nEnter first Hospital ID: ";
+    getline(cin, id1);
+    
+    cout << "Enter second Hospital ID: ";
+    getline(cin, id2);
+    
+    network.displayConnectivity(id1, id2);
 }
 
 // Function to handle delete all hospitals
@@ -200,7 +249,109 @@ void handleDeleteAllConnections(HospitalNetwork& network) {
     }
 }
 
-int main() {
+// Function to handle performance metrics display and export
+void handleMetrics(HospitalNetwork& network) {
+    network.displayMetrics();
+    
+    char confirm;
+    cout << "\nExport metrics to metrics.json? (y/n): ";
+    cin >> confirm;
+    clearInputBuffer();
+    
+    if (confirm == 'y' || confirm == 'Y') {
+        if (network.exportMetrics("metrics.json")) {
+            cout << "Metrics exported to metrics.json\n";
+        } else {
+            cout << "Error: Could not write metrics.json\n";
+        }
+    }
+}
+
+// Parse a whole-number flag value; rejects signs, junk and overflow
+bool parseCount(const string& text, size_t minimum, size_t& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != string::npos) return false;
+    errno = 0;
+    unsigned long long parsed = strtoull(text.c_str(), nullptr, 10);
+    if (errno == ERANGE || parsed < minimum || parsed > numeric_limits<size_t>::max()) return false;
+    value = (size_t)parsed;
+    return true;
+}
+
+// Function to run batch mode; returns the process exit code
+int runBatch(int argc, char* argv[]) {
+    string inputFile, outputFile;
+    BatchOptions options;
+    
+    for (int i = 1; i < argc; i++) {
+        string flag = argv[i];
+        if (flag == "--echo") {
+            options.echo = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Error: " << flag << " needs a value.\n";
+            return 1;
+        }
+        string value = argv[++i];
+        if (flag == "--batch") {
+            inputFile = value;
+        } else if (flag == "--output") {
+            outputFile = value;
+        } else if (flag == "--transaction-size") {
+            if (!parseCount(value, 1, options.transactionSize)) {
+                cerr << "Error: --transaction-size needs a whole number of at least 1.\n";
+                return 1;
+            }
+        } else if (flag == "--checkpoint-every") {
+            if (!parseCount(value, 0, options.checkpointEvery)) {
+                cerr << "Error: --checkpoint-every needs a whole number (0 = only at exit).\n";
+                return 1;
+            }
+        } else {
+            cerr << "Error: Unknown option " << flag << "\n";
+            return 1;
+        }
+    }
+    if (inputFile.empty()) {
+        cerr << "Usage: hospital_network --batch FILE|- [--output FILE] "
+             << "[--transaction-size N] [--checkpoint-every N] [--echo]\n";
+        return 1;
+    }
+    
+    ifstream commandFile;
+    if (inputFile != "-") {
+        commandFile.open(inputFile);
+        if (!commandFile.is_open()) {
+            cerr << "Error: Could not open " << inputFile << "\n";
+            return 1;
+        }
+    }
+    istream& in = (inputFile == "-") ? cin : commandFile;
+    
+    // Results are block-buffered, not flushed per line
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+    ofstream resultFile;
+    if (!outputFile.empty()) {
+        resultFile.open(outputFile);
+        if (!resultFile.is_open()) {
+            cerr << "Error: Could not write " << outputFile << "\n";
+            return 1;
+        }
+    }
+    ostream out(outputFile.empty() ? cout.rdbuf() : resultFile.rdbuf());
+    
+    HospitalNetwork network;
+    BatchProcessor processor(network, out, options);
+    BatchSummary summary = processor.run(in);
+    return summary.errors == 0 ? 0 : 2;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        return runBatch(argc, argv);
+    }
+    
     HospitalNetwork network;
     int choice;
     
@@ -256,6 +407,21 @@ int main() {
             case 15:
                 handleDeleteAllConnections(network);
                 break;
+            case 16:
+                handleMetrics(network);
+                break;
+            case 17:
+                handleNearestWithCapacity(network);
+                break;
+            case 18:
+                network.buildContractionHierarchy();
+                break;
+            case 19:
+                network.displayComponents();
+                break;
+            case 20:
+                handleConnectivity(network);
+                break;
             case 0:
                 cout << "Exiting program...\n";
                 break;
@@ -0,0 +1,330 @@
+#include "network_diagram.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+static string escapeXml(const string& text) {
+    string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out += c;
+        }
+    }
+    return out;
+}
+
+bool NetworkDiagram::renderSVG(const NetworkGraph& graph, const vector<string>& labels,
+                               const string& filename, const DiagramOptions& options) {
+    const vector<int>& offsets = graph.getOffsets();
+    const vector<int>& targets = graph.getTargets();
+    int n = graph.vertexCount();
+
+    vector<int> degree(n, 0);
+    for (int v = 0; v < n; v++) {
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            if (targets[e] != NetworkGraph::NO_VERTEX) degree[v]++;
+        }
+    }
+
+    // Level of detail: fold hospitals below the degree threshold into their
+    // best-connected neighbour; unconnected ones are hidden (-1)
+    int threshold = options.collapseBelowDegree;
+    if (threshold == 0 && (size_t)n > options.autoCollapseAbove) threshold = 2;
+
+    const int UNASSIGNED = -2;
+    const int REMOVED = -3;
+    vector<int> rep(n, UNASSIGNED);
+    vector<int> collapsed;
+    for (int v = 0; v < n; v++) {
+        if (graph.isRemoved(v)) rep[v] = REMOVED;
+        else if (degree[v] >= threshold) rep[v] = v;
+        else if (degree[v] == 0) rep[v] = -1;
+        else collapsed.push_back(v);
+    }
+    stable_sort(collapsed.begin(), collapsed.end(),
+                [&](int a, int b) { return degree[a] > degree[b]; });
+    for (int v : collapsed) {
+        int best = NetworkGraph::NO_VERTEX;
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            int u = targets[e];
+            if (u != NetworkGraph::NO_VERTEX && (best < 0 || degree[u] > degree[best])) best = u;
+        }
+        // A neighbour that is still unassigned cannot absorb v, so v stays
+        rep[v] = (rep[best] >= 0) ? rep[best] : v;
+    }
+
+    // Compact the visible nodes
+    vector<int> node(n, -1);
+    vector<int> vertexOf;
+    for (int v = 0; v < n; v++) {
+        if (rep[v] == v) {
+            node[v] = (int)vertexOf.size();
+            vertexOf.push_back(v);
+        }
+    }
+    int m = (int)vertexOf.size();
+    vector<double> mass(m, 0);
+    int hidden = 0;
+    for (int v = 0; v < n; v++) {
+        if (rep[v] >= 0) mass[node[rep[v]]] += 1;
+        else if (rep[v] != REMOVED) hidden++;
+    }
+
+    vector<pair<int, int>> edges;
+    for (int v = 0; v < n; v++) {
+        if (rep[v] < 0) continue;
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            int u = targets[e];
+            if (u == NetworkGraph::NO_VERTEX || rep[u] < 0) continue;
+            int a = node[rep[v]], b = node[rep[u]];
+            if (a < b) edges.push_back({a, b});
+        }
+    }
+    sort(edges.begin(), edges.end());
+    edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+    vector<vector<int>> adjacency(m);
+    for (const auto& edge : edges) {
+        adjacency[edge.first].push_back(edge.second);
+        adjacency[edge.second].push_back(edge.first);
+    }
+
+    vector<Point> positions;
+    layout(adjacency, mass, positions, options);
+
+    // Stream the SVG
+    ofstream svg(filename);
+    if (!svg.is_open()) return false;
+
+    svg << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"" << options.width
+        << "\" height=\"" << options.height << "\" viewBox=\"0 0 "
+        << options.width << " " << options.height << "\">\n"
+        << "<rect width=\"100%\" height=\"100%\" fill=\"white\"/>\n";
+
+    svg << "<g stroke=\"#8899aa\" stroke-width=\"0.8\" stroke-opacity=\"0.7\">\n";
+    for (const auto& edge : edges) {
+        const Point& a = positions[edge.first];
+        const Point& b = positions[edge.second];
+        svg << "<line x1=\"" << a.x << "\" y1=\"" << a.y
+            << "\" x2=\"" << b.x << "\" y2=\"" << b.y << "\"/>\n";
+    }
+    svg << "</g>\n";
+
+    bool drawLabels = (size_t)m <= options.labelLimit;
+    svg << "<g fill=\"lightblue\" stroke=\"#336699\" stroke-width=\"0.8\">\n";
+    for (int i = 0; i < m; i++) {
+        int v = vertexOf[i];
+        double radius = (drawLabels ? 8.0 : 3.0) + 2.0 * sqrt(mass[i] - 1);
+        svg << "<circle cx=\"" << positions[i].x << "\" cy=\"" << positions[i].y
+            << "\" r=\"" << radius << "\"><title>" << escapeXml(labels[v]);
+        if (mass[i] > 1) svg << " (+" << mass[i] - 1 << " folded)";
+        svg << "</title></circle>\n";
+    }
+    svg << "</g>\n";
+
+    if (drawLabels) {
+        svg << "<g font-family=\"sans-serif\" font-size=\"9\" text-anchor=\"middle\">\n";
+        for (int i = 0; i < m; i++) {
+            svg << "<text x=\"" << positions[i].x << "\" y=\"" << positions[i].y + 3
+                << "\">" << escapeXml(graph.idOf(vertexOf[i])) << "</text>\n";
+        }
+        svg << "</g>\n";
+    }
+
+    int folded = n - m - hidden;
+    for (int v = 0; v < n; v++) {
+        if (rep[v] == REMOVED) folded--;
+    }
+    if (folded > 0 || hidden > 0) {
+        svg << "<text x=\"10\" y=\"20\" font-family=\"sans-serif\" font-size=\"12\">"
+            << folded << " low-degree hospitals folded into neighbours, "
+            << hidden << " unconnected hospitals not shown</text>\n";
+    }
+    svg << "</svg>\n";
+
+    return svg.good();
+}
+
+// Fruchterman-Reingold layout: repulsion k^2/d between all pairs (via the
+// quadtree), attraction d^2/k along connections, moves capped by a
+// temperature that cools linearly
+void NetworkDiagram::layout(const vector<vector<int>>& adjacency, const vector<double>& mass,
+                            vector<Point>& positions, const DiagramOptions& options) {
+    int m = (int)adjacency.size();
+    double margin = 20;
+    double width = options.width - 2 * margin;
+    double height = options.height - 2 * margin;
+
+    mt19937 rng(options.seed);
+    uniform_real_distribution<double> randomX(margin, margin + width);
+    uniform_real_distribution<double> randomY(margin, margin + height);
+    positions.resize(m);
+    for (auto& p : positions) p = {randomX(rng), randomY(rng)};
+    if (m < 2) return;
+
+    int iterations = options.iterations;
+    if (iterations <= 0) iterations = (int)min(300.0, max(30.0, 2e6 / m));
+
+    double k = sqrt(width * height / m);
+    double k2 = k * k;
+    double theta2 = options.theta * options.theta;
+    double temperature = width / 10;
+    double cooling = temperature / (iterations + 1);
+
+    unsigned threadCount = options.threads ? options.threads : max(1u, thread::hardware_concurrency());
+    threadCount = (unsigned)min<size_t>(threadCount, max(1, m / 256));
+
+    vector<Cell> cells;
+    vector<Point> displacement(m);
+    for (int iter = 0; iter < iterations; iter++) {
+        buildTree(cells, positions, mass);
+
+        // Each thread owns a range of vertices; the tree and positions are
+        // read-only until every force has been computed
+        auto work = [&](int begin, int end) {
+            for (int v = begin; v < end; v++) {
+                Point force = repulsion(cells, positions[v], v, k2, theta2);
+                force.x *= mass[v];
+                force.y *= mass[v];
+                for (int u : adjacency[v]) {
+                    double dx = positions[u].x - positions[v].x;
+                    double dy = positions[u].y - positions[v].y;
+                    double d = sqrt(dx * dx + dy * dy);
+                    force.x += dx * d / k;
+                    force.y += dy * d / k;
+                }
+                displacement[v] = force;
+            }
+        };
+
+        vector<thread> pool;
+        int chunk = (m + threadCount - 1) / threadCount;
+        for (unsigned t = 1; t < threadCount; t++) {
+            pool.emplace_back(work, min(m, (int)t * chunk), min(m, (int)(t + 1) * chunk));
+        }
+        work(0, min(m, chunk));
+        for (auto& t : pool) t.join();
+
+        for (int v = 0; v < m; v++) {
+            double length = sqrt(displacement[v].x * displacement[v].x +
+                                 displacement[v].y * displacement[v].y);
+            if (length > 0) {
+                double step = min(length, temperature) / length;
+                positions[v].x += displacement[v].x * step;
+                positions[v].y += displacement[v].y * step;
+            }
+            positions[v].x = min(margin + width, max(margin, positions[v].x));
+            positions[v].y = min(margin + height, max(margin, positions[v].y));
+        }
+        temperature -= cooling;
+    }
+}
+
+// Barnes-Hut quadtree
+void NetworkDiagram::buildTree(vector<Cell>& cells, const vector<Point>& positions,
+                               const vector<double>& mass) {
+    double minX = positions[0].x, maxX = minX, minY = positions[0].y, maxY = minY;
+    for (const auto& p : positions) {
+        minX = min(minX, p.x);
+        maxX = max(maxX, p.x);
+        minY = min(minY, p.y);
+        maxY = max(maxY, p.y);
+    }
+
+    cells.clear();
+    cells.reserve(positions.size() * 2);
+    Cell root;
+    root.cx = (minX + maxX) / 2;
+    root.cy = (minY + maxY) / 2;
+    root.half = max(maxX - minX, maxY - minY) / 2 + 1e-6;
+    cells.push_back(root);
+
+    for (int body = 0; body < (int)positions.size(); body++) {
+        insert(cells, 0, body, positions, mass, 0);
+    }
+}
+
+void NetworkDiagram::insert(vector<Cell>& cells, int cell, int body,
+                            const vector<Point>& positions, const vector<double>& mass, int depth) {
+    const Point& p = positions[body];
+    bool empty = (cells[cell].mass == 0);
+    bool leaf = (cells[cell].child[0] < 0 && cells[cell].child[1] < 0 &&
+                 cells[cell].child[2] < 0 && cells[cell].child[3] < 0);
+
+    cells[cell].mass += mass[body];
+    cells[cell].massX += p.x * mass[body];
+    cells[cell].massY += p.y * mass[body];
+
+    if (empty && leaf) {
+        cells[cell].body = body;
+        return;
+    }
+    if (leaf && depth > 40) return;     // Coincident points share one leaf
+
+    // Push an existing single body down before descending
+    int moved = -1;
+    if (leaf) {
+        moved = cells[cell].body;
+        cells[cell].body = -1;
+    }
+
+    for (int b : {moved, body}) {
+        if (b < 0) continue;
+        const Point& q = positions[b];
+        int quadrant = (q.x >= cells[cell].cx ? 1 : 0) + (q.y >= cells[cell].cy ? 2 : 0);
+        if (cells[cell].child[quadrant] < 0) {
+            Cell child;
+            child.half = cells[cell].half / 2;
+            child.cx = cells[cell].cx + ((quadrant & 1) ? child.half : -child.half);
+            child.cy = cells[cell].cy + ((quadrant & 2) ? child.half : -child.half);
+            cells.push_back(child);
+            cells[cell].child[quadrant] = (int)cells.size() - 1;
+        }
+        insert(cells, cells[cell].child[quadrant], b, positions, mass, depth + 1);
+    }
+}
+
+NetworkDiagram::Point NetworkDiagram::repulsion(const vector<Cell>& cells, const Point& at,
+                                                int self, double k2, double theta2) {
+    Point force = {0, 0};
+    int stack[256];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        const Cell& cell = cells[stack[--top]];
+        if (cell.mass == 0 || cell.body == self) continue;
+
+        double dx = at.x - cell.massX / cell.mass;
+        double dy = at.y - cell.massY / cell.mass;
+        double d2 = dx * dx + dy * dy;
+        bool leaf = cell.body >= 0;
+        double size = 2 * cell.half;
+
+        if (leaf || size * size < theta2 * d2) {
+            if (d2 < 1e-4) {            // Nudge apart coincident points
+                dx = (self % 7) - 3 + 0.5;
+                dy = (self % 5) - 2 + 0.5;
+                d2 = dx * dx + dy * dy;
+            }
+            double scale = k2 * cell.mass / d2;
+            force.x += dx * scale;
+            force.y += dy * scale;
+        } else {
+            for (int c : cell.child) {
+                if (c >= 0 && top < 256) stack[top++] = c;
+            }
+        }
+    }
+    return force;
+}
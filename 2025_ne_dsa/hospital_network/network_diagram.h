@@ -0,0 +1,68 @@
+/**
+ * Network Diagram Header
+ *
+ * Draws the hospital network as an SVG file without calling Graphviz.
+ * Positions come from a force-directed layout: connections pull hospitals
+ * together and every pair pushes apart. The all-pairs repulsion uses a
+ * Barnes-Hut quadtree, so an iteration costs O(n log n), and forces are
+ * computed on several threads.
+ *
+ * For large networks a level-of-detail pass folds low-degree hospitals
+ * into a neighbour. Such a hospital is drawn as part of a larger circle
+ * and isolated hospitals are only counted.
+ */
+
+#ifndef NETWORK_DIAGRAM_H
+#define NETWORK_DIAGRAM_H
+
+#include "network_graph.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct DiagramOptions {
+    double width = 1600;
+    double height = 1200;
+    int iterations = 0;                 // 0 = pick from network size
+    unsigned threads = 0;               // 0 = all cores
+    double theta = 0.8;                 // Barnes-Hut accuracy (lower = exact)
+    int collapseBelowDegree = 0;        // Fold hospitals with fewer connections
+    size_t autoCollapseAbove = 5000;    // ...or below 2 when there are more hospitals
+    size_t labelLimit = 2000;           // No text labels above this many nodes
+    unsigned seed = 1;
+};
+
+class NetworkDiagram {
+public:
+    // labels[v] is the tooltip for vertex v (e.g. "H1 - City Hospital")
+    static bool renderSVG(const NetworkGraph& graph, const vector<string>& labels,
+                          const string& filename, const DiagramOptions& options);
+
+private:
+    struct Point {
+        double x;
+        double y;
+    };
+
+    // One cell of the Barnes-Hut quadtree
+    struct Cell {
+        double cx, cy, half;            // Square centre and half width
+        double massX = 0, massY = 0;    // Mass-weighted position sum
+        double mass = 0;
+        int body = -1;                  // Single body stored here, if a leaf
+        int child[4] = {-1, -1, -1, -1};
+    };
+
+    static void buildTree(vector<Cell>& cells, const vector<Point>& positions,
+                          const vector<double>& mass);
+    static void insert(vector<Cell>& cells, int cell, int body,
+                       const vector<Point>& positions, const vector<double>& mass, int depth);
+    static Point repulsion(const vector<Cell>& cells, const Point& at, int self,
+                           double k2, double theta2);
+
+    static void layout(const vector<vector<int>>& adjacency, const vector<double>& mass,
+                       vector<Point>& positions, const DiagramOptions& options);
+};
+
+#endif // NETWORK_DIAGRAM_H
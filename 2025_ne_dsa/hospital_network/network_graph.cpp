@@ -0,0 +1,296 @@
+#include "network_graph.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+using namespace std;
+
+const int NetworkGraph::NO_VERTEX;
+
+// Workspace
+void PathWorkspace::reset(int vertexCount) {
+    if ((int)dist.size() != vertexCount) {
+        dist.assign(vertexCount, numeric_limits<double>::infinity());
+        prev.assign(vertexCount, NetworkGraph::NO_VERTEX);
+    } else {
+        for (int v : touched) {
+            dist[v] = numeric_limits<double>::infinity();
+            prev[v] = NetworkGraph::NO_VERTEX;
+        }
+    }
+    touched.clear();
+    heap.clear();
+    settled = 0;
+    relaxed = 0;
+}
+
+// Building
+void NetworkGraph::rebuild(const map<string, Hospital>& hospitals) {
+    clear();
+    ids.reserve(hospitals.size());
+    for (const auto& pair : hospitals) {
+        index[pair.first] = (int)ids.size();
+        ids.push_back(pair.first);
+        loads.addVertex(pair.second.getPatientCount());
+    }
+
+    offsets.reserve(ids.size() + 1);
+    for (const auto& pair : hospitals) {
+        int degree = 0;
+        for (const auto& connection : pair.second.getConnectionView()) {
+            auto target = index.find(connection.first);
+            if (target == index.end()) continue;
+
+            targets.push_back(target->second);
+            weights.push_back(connection.second.distance);
+            degree++;
+        }
+        addSpares(sparesFor(degree));
+        offsets.push_back((int)targets.size());
+    }
+}
+
+// The snapshot is already CSR with vertices in ID order, which is the
+// order rebuild(map) numbers them in, so no edge needs a lookup
+void NetworkGraph::rebuild(const NetworkSnapshot& snapshot) {
+    clear();
+    uint32_t n = snapshot.getHospitalCount();
+    ids.reserve(n);
+    index.reserve(n);
+    offsets.reserve(n + 1);
+    targets.reserve(snapshot.getEdgeCount() + n);
+    weights.reserve(snapshot.getEdgeCount() + n);
+    for (uint32_t i = 0; i < n; i++) {
+        const SnapshotHospital& record = snapshot.getHospital(i);
+        ids.emplace_back(snapshot.text(record.id));
+        index.emplace(ids.back(), (int)i);
+        loads.addVertex(record.patientCount);
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t e = snapshot.edgeBegin(i); e < snapshot.edgeEnd(i); e++) {
+            const SnapshotEdge& edge = snapshot.getEdge(e);
+            targets.push_back((int)edge.target);
+            weights.push_back(edge.distance);
+        }
+        addSpares(sparesFor((int)(snapshot.edgeEnd(i) - snapshot.edgeBegin(i))));
+        offsets.push_back((int)targets.size());
+    }
+}
+
+void NetworkGraph::addSpares(int count) {
+    targets.insert(targets.end(), count, NO_VERTEX);
+    weights.insert(weights.end(), count, 0.0);
+    freeSlots += count;
+    spareSlots += count;
+}
+
+void NetworkGraph::clear() {
+    freeSlots = 0;
+    spareSlots = 0;
+    ids.clear();
+    index.clear();
+    offsets.assign(1, 0);
+    targets.clear();
+    weights.clear();
+    loads.clear();
+}
+
+// Patching
+int NetworkGraph::addVertex(const string& id, int patientCount) {
+    if (offsets.empty()) offsets.push_back(0);
+
+    int vertex = (int)ids.size();
+    ids.push_back(id);
+    index[id] = vertex;
+    addSpares(sparesFor(0));
+    offsets.push_back((int)targets.size());
+    loads.addVertex(patientCount);
+    return vertex;
+}
+
+void NetworkGraph::setPatientCount(int vertex, int patientCount) {
+    loads.set(vertex, patientCount);
+}
+
+// Tombstone every edge touching vertex and unmap its ID. The vertex
+// number stays allocated (isolated) until the next rebuild.
+void NetworkGraph::removeVertex(int vertex) {
+    if (vertex < 0 || vertex >= vertexCount() || isRemoved(vertex)) return;
+
+    for (int e = offsets[vertex]; e < offsets[vertex + 1]; e++) {
+        if (targets[e] == NO_VERTEX) continue;
+        removeEdge(targets[e], vertex);
+        targets[e] = NO_VERTEX;
+        freeSlots++;
+    }
+    index.erase(ids[vertex]);
+    loads.remove(vertex);
+}
+
+bool NetworkGraph::removeEdge(int from, int to) {
+    int edge = findEdge(from, to);
+    if (edge < 0) return false;
+    targets[edge] = NO_VERTEX;
+    freeSlots++;
+    return true;
+}
+
+// Fill the first free slot in from's row
+bool NetworkGraph::addEdge(int from, int to, double weight) {
+    if (from < 0 || from >= vertexCount() || to < 0 || to >= vertexCount()) return false;
+    for (int e = offsets[from]; e < offsets[from + 1]; e++) {
+        if (targets[e] != NO_VERTEX) continue;
+        targets[e] = to;
+        weights[e] = weight;
+        freeSlots--;
+        return true;
+    }
+    return false;
+}
+
+bool NetworkGraph::setWeight(int from, int to, double weight) {
+    int edge = findEdge(from, to);
+    if (edge < 0) return false;
+    weights[edge] = weight;
+    return true;
+}
+
+int NetworkGraph::findEdge(int from, int to) const {
+    if (from < 0 || from >= vertexCount() || to < 0) return -1;
+    for (int e = offsets[from]; e < offsets[from + 1]; e++) {
+        if (targets[e] == to) return e;
+    }
+    return -1;
+}
+
+// Lookup
+int NetworkGraph::indexOf(const string& id) const {
+    auto it = index.find(id);
+    return (it != index.end()) ? it->second : NO_VERTEX;
+}
+
+const string& NetworkGraph::idOf(int vertex) const {
+    return ids[vertex];
+}
+
+int NetworkGraph::wastedSlotCount() const {
+    return max(0, freeSlots - spareSlots);
+}
+
+int NetworkGraph::vertexCount() const {
+    return (int)ids.size();
+}
+
+bool NetworkGraph::isRemoved(int vertex) const {
+    auto it = index.find(ids[vertex]);
+    return it == index.end() || it->second != vertex;
+}
+
+// Dijkstra over the CSR arrays
+bool NetworkGraph::shortestPaths(int source, int target, PathWorkspace& ws) const {
+    ws.reset(vertexCount());
+    if (source < 0 || source >= vertexCount()) return false;
+
+    auto cmp = greater<pair<double, int>>();
+    ws.dist[source] = 0;
+    ws.touched.push_back(source);
+    ws.heap.push_back({0, source});
+
+    while (!ws.heap.empty()) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), cmp);
+        pair<double, int> top = ws.heap.back();
+        ws.heap.pop_back();
+
+        int current = top.second;
+        if (top.first > ws.dist[current]) continue;   // Stale heap entry
+        ws.settled++;
+        if (current == target) return true;
+
+        for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+            int neighbor = targets[e];
+            if (neighbor == NO_VERTEX) continue;
+
+            double candidate = ws.dist[current] + weights[e];
+            if (candidate < ws.dist[neighbor]) {
+                ws.relaxed++;
+                if (ws.dist[neighbor] == numeric_limits<double>::infinity()) {
+                    ws.touched.push_back(neighbor);
+                }
+                ws.dist[neighbor] = candidate;
+                ws.prev[neighbor] = current;
+                ws.heap.push_back({candidate, neighbor});
+                push_heap(ws.heap.begin(), ws.heap.end(), cmp);
+            }
+        }
+    }
+
+    return target == NO_VERTEX;
+}
+
+// Dijkstra that stops as soon as enough hospitals with capacity are settled
+vector<int> NetworkGraph::nearestWithCapacity(int source, int k, int threshold,
+                                              PathWorkspace& ws) const {
+    vector<int> found;
+    ws.reset(vertexCount());
+    if (source < 0 || source >= vertexCount() || k <= 0) return found;
+
+    int available = loads.countBelow(threshold);
+    if (loads.hasCapacity(source, threshold)) available--;
+    size_t wanted = (size_t)max(0, min(k, available));
+    if (wanted == 0) return found;
+
+    auto cmp = greater<pair<double, int>>();
+    ws.dist[source] = 0;
+    ws.touched.push_back(source);
+    ws.heap.push_back({0, source});
+
+    while (!ws.heap.empty()) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), cmp);
+        pair<double, int> top = ws.heap.back();
+        ws.heap.pop_back();
+
+        int current = top.second;
+        if (top.first > ws.dist[current]) continue;   // Stale heap entry
+        ws.settled++;
+        if (current != source && loads.hasCapacity(current, threshold)) {
+            found.push_back(current);
+            if (found.size() == wanted) break;
+        }
+
+        for (int e = offsets[current]; e < offsets[current + 1]; e++) {
+            int neighbor = targets[e];
+            if (neighbor == NO_VERTEX) continue;
+
+            double candidate = ws.dist[current] + weights[e];
+            if (candidate < ws.dist[neighbor]) {
+                ws.relaxed++;
+                if (ws.dist[neighbor] == numeric_limits<double>::infinity()) {
+                    ws.touched.push_back(neighbor);
+                }
+                ws.dist[neighbor] = candidate;
+                ws.prev[neighbor] = current;
+                ws.heap.push_back({candidate, neighbor});
+                push_heap(ws.heap.begin(), ws.heap.end(), cmp);
+            }
+        }
+    }
+    return found;
+}
+
+vector<int> NetworkGraph::extractPath(const PathWorkspace& ws, int target) {
+    return extractPath(ws.dist, ws.prev, target);
+}
+
+vector<int> NetworkGraph::extractPath(const vector<double>& dist,
+                                      const vector<int>& prev, int target) {
+    vector<int> path;
+    if (target < 0 || target >= (int)dist.size()) return path;
+    if (dist[target] == numeric_limits<double>::infinity()) return path;
+
+    for (int at = target; at != NO_VERTEX; at = prev[at]) {
+        path.push_back(at);
+    }
+    reverse(path.begin(), path.end());
+    return path;
+}
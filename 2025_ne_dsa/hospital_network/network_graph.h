@@ -0,0 +1,107 @@
+/**
+ * Network Graph Header
+ *
+ * This class keeps a flat, integer-indexed copy of the hospital connections
+ * in compressed-sparse-row (CSR) form. Hospital IDs are interned to vertex
+ * numbers 0..n-1 and the neighbours of vertex v are stored in
+ * targets[offsets[v] .. offsets[v + 1]) with matching weights.
+ *
+ * Path queries run on these arrays instead of the string-keyed maps in
+ * HospitalNetwork, so a relaxation is an array read rather than a map lookup.
+ *
+ * Free slots hold NO_VERTEX and are skipped by every reader. Removing an
+ * edge tombstones its slot, and each row also gets a few spare slots when
+ * it is built, so addEdge usually fills a free slot in place instead of
+ * forcing a rebuild.
+ */
+
+#ifndef NETWORK_GRAPH_H
+#define NETWORK_GRAPH_H
+
+#include "hospital.h"
+#include "network_snapshot.h"
+#include "patient_load_index.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
+using namespace std;
+
+// Reusable buffers for single-source searches over a NetworkGraph.
+// Only the entries touched by the previous search are reset, so a query
+// costs O(vertices settled) instead of O(network size) in setup.
+struct PathWorkspace {
+    vector<double> dist;                 // Tentative distance per vertex
+    vector<int> prev;                    // Predecessor per vertex (-1 = none)
+    vector<pair<double, int>> heap;      // Binary min-heap of (distance, vertex)
+    vector<int> touched;                 // Vertices written by the last search
+    long long settled = 0;               // Vertices popped by the last search
+    long long relaxed = 0;               // Edges that lowered a distance
+
+    void reset(int vertexCount);
+};
+
+class NetworkGraph {
+public:
+    static const int NO_VERTEX = -1;
+
+    // Rebuild every array from the network's hospital map, or straight
+    // from a snapshot's CSR (same vertex numbering as its hospital array)
+    void rebuild(const map<string, Hospital>& hospitals);
+    void rebuild(const NetworkSnapshot& snapshot);
+    void clear();
+
+    // Incremental patches that keep the CSR valid without a rebuild
+    int addVertex(const string& id, int patientCount = 0);
+    void setPatientCount(int vertex, int patientCount);
+    void removeVertex(int vertex);
+    bool addEdge(int from, int to, double weight);      // False when the row is full
+    bool removeEdge(int from, int to);
+    bool setWeight(int from, int to, double weight);
+
+    // Vertex lookup
+    int indexOf(const string& id) const;
+    const string& idOf(int vertex) const;
+    int vertexCount() const;
+    bool isRemoved(int vertex) const;
+    int wastedSlotCount() const;        // Free slots beyond the spares handed out
+
+    // Single-source Dijkstra from source. Stops once target is settled,
+    // or settles every reachable vertex when target is NO_VERTEX.
+    // Returns true when target (if given) is reachable.
+    bool shortestPaths(int source, int target, PathWorkspace& ws) const;
+
+    // The k closest vertices (excluding source) with fewer than threshold
+    // patients, nearest first. Stops once k of them are settled, or once
+    // every qualifying vertex in the network has been found.
+    vector<int> nearestWithCapacity(int source, int k, int threshold, PathWorkspace& ws) const;
+
+    // Vertex sequence from the source of a search to target
+    static vector<int> extractPath(const PathWorkspace& ws, int target);
+    static vector<int> extractPath(const vector<double>& dist,
+                                   const vector<int>& prev, int target);
+
+    // CSR arrays (read-only access for algorithms)
+    const vector<int>& getOffsets() const { return offsets; }
+    const vector<int>& getTargets() const { return targets; }
+    const vector<double>& getWeights() const { return weights; }
+    const PatientLoadIndex& getLoadIndex() const { return loads; }
+
+private:
+    vector<string> ids;                  // Vertex number -> hospital ID
+    unordered_map<string, int> index;    // Hospital ID -> vertex number
+    vector<int> offsets;                 // Size n + 1
+    vector<int> targets;                 // Neighbour per edge (NO_VERTEX = removed)
+    vector<double> weights;              // Distance per edge
+    int freeSlots = 0;                   // NO_VERTEX entries in targets
+    int spareSlots = 0;                  // Free slots reserved by rebuild and addVertex
+    PatientLoadIndex loads;              // Patient count per vertex
+
+    static int sparesFor(int degree) { return 1 + degree / 4; }
+    void addSpares(int count);
+    int findEdge(int from, int to) const;
+};
+
+#endif // NETWORK_GRAPH_H
@@ -0,0 +1,261 @@
+#include "network_journal.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#define JOURNAL_OPEN(name) _open(name, _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE)
+#define JOURNAL_WRITE _write
+#define JOURNAL_SYNC _commit
+#define JOURNAL_TRUNCATE _chsize_s
+#define JOURNAL_SEEK_END(fd) _lseeki64(fd, 0, SEEK_END)
+#define JOURNAL_CLOSE _close
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define JOURNAL_OPEN(name) ::open(name, O_RDWR | O_CREAT, 0644)
+#define JOURNAL_WRITE ::write
+#define JOURNAL_SYNC ::fsync
+#define JOURNAL_TRUNCATE ::ftruncate
+#define JOURNAL_SEEK_END(fd) ::lseek(fd, 0, SEEK_END)
+#define JOURNAL_CLOSE ::close
+#endif
+
+using namespace std;
+
+// CRC-32 (IEEE 802.3 polynomial), table built on first use
+static uint32_t crc32(const char* data, size_t length) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        ready = true;
+    }
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc = table[(crc ^ (uint8_t)data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+NetworkJournal::NetworkJournal() : stopping(false), fd(-1), pendingRecords(0), bytesWritten(0) {}
+
+NetworkJournal::~NetworkJournal() {
+    close();
+}
+
+// Encoding
+string NetworkJournal::encode(const JournalRecord& record) {
+    string payload;
+    auto putRaw = [&](const void* value, size_t size) {
+        payload.append(static_cast<const char*>(value), size);
+    };
+    auto putString = [&](const string& value) {
+        uint32_t length = (uint32_t)value.size();
+        putRaw(&length, sizeof(length));
+        payload += value;
+    };
+
+    uint8_t op = (uint8_t)record.op;
+    int32_t patientCount = record.patientCount;
+    putRaw(&op, sizeof(op));
+    putString(record.id);
+    putString(record.otherId);
+    putString(record.name);
+    putString(record.location);
+    putString(record.description);
+    putRaw(&patientCount, sizeof(patientCount));
+    putRaw(&record.distance, sizeof(record.distance));
+
+    uint32_t header[2] = {(uint32_t)payload.size(), crc32(payload.data(), payload.size())};
+    return string(reinterpret_cast<const char*>(header), sizeof(header)) + payload;
+}
+
+bool NetworkJournal::decode(const char* data, size_t length, JournalRecord& record) {
+    size_t position = 0;
+    auto getRaw = [&](void* value, size_t size) {
+        if (position + size > length) return false;
+        memcpy(value, data + position, size);
+        position += size;
+        return true;
+    };
+    auto getString = [&](string& value) {
+        uint32_t size;
+        if (!getRaw(&size, sizeof(size)) || position + size > length) return false;
+        value.assign(data + position, size);
+        position += size;
+        return true;
+    };
+
+    uint8_t op;
+    int32_t patientCount;
+    bool ok = getRaw(&op, sizeof(op)) &&
+              getString(record.id) && getString(record.otherId) &&
+              getString(record.name) && getString(record.location) &&
+              getString(record.description) &&
+              getRaw(&patientCount, sizeof(patientCount)) &&
+              getRaw(&record.distance, sizeof(record.distance));
+    if (!ok || op < (uint8_t)JournalOp::AddHospital ||
+        op > (uint8_t)JournalOp::DeleteAllConnections) {
+        return false;
+    }
+
+    record.op = (JournalOp)op;
+    record.patientCount = patientCount;
+    return position == length;
+}
+
+// Recovery
+uint64_t NetworkJournal::replay(const string& filename,
+                                const function<void(const JournalRecord&)>& apply) {
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return 0;
+    string contents((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    uint64_t position = 0;
+    while (position + 8 <= contents.size()) {
+        uint32_t header[2];
+        memcpy(header, contents.data() + position, sizeof(header));
+        uint64_t end = position + 8 + header[0];
+        if (end > contents.size()) break;                               // Torn write
+
+        const char* payload = contents.data() + position + 8;
+        if (crc32(payload, header[0]) != header[1]) break;              // Corrupt record
+
+        JournalRecord record;
+        if (!decode(payload, header[0], record)) break;
+        apply(record);
+        position = end;
+    }
+    return position;
+}
+
+// Appending
+bool NetworkJournal::open(const string& filename, uint64_t validLength) {
+    close();
+    lock_guard<mutex> guard(lock);
+    fd = JOURNAL_OPEN(filename.c_str());
+    if (fd < 0) return false;
+
+    if ((uint64_t)JOURNAL_SEEK_END(fd) > validLength) {
+        JOURNAL_TRUNCATE(fd, validLength);
+    }
+    bytesWritten = (uint64_t)JOURNAL_SEEK_END(fd);
+    stopping = false;
+    flusher = thread(&NetworkJournal::flushWhenDue, this);
+    return true;
+}
+
+void NetworkJournal::close() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (flusher.joinable()) flusher.join();
+
+    lock_guard<mutex> guard(lock);
+    if (fd < 0) return;
+    flushLocked();
+    JOURNAL_CLOSE(fd);
+    fd = -1;
+}
+
+bool NetworkJournal::append(const JournalRecord& record) {
+    lock_guard<mutex> guard(lock);
+    if (fd < 0) return false;
+
+    if (pendingRecords == 0) {
+        oldestPending = chrono::steady_clock::now();
+        wake.notify_one();          // Start the delay clock
+    }
+    pending += encode(record);
+    pendingRecords++;
+
+    bool due = pendingRecords >= policy.maxPendingRecords ||
+               chrono::steady_clock::now() - oldestPending >=
+                   chrono::milliseconds(policy.maxDelayMs);
+    return due ? flushLocked() : true;
+}
+
+bool NetworkJournal::flush() {
+    lock_guard<mutex> guard(lock);
+    return flushLocked();
+}
+
+// Sleeps until the oldest pending record is due, then flushes. A failed
+// write is retried after another full delay rather than in a tight loop.
+void NetworkJournal::flushWhenDue() {
+    unique_lock<mutex> guard(lock);
+    while (!stopping) {
+        if (pendingRecords == 0) {
+            wake.wait(guard);
+            continue;
+        }
+        auto due = oldestPending + chrono::milliseconds(policy.maxDelayMs);
+        if (chrono::steady_clock::now() < due) {
+            wake.wait_until(guard, due);
+            continue;
+        }
+        if (!flushLocked()) oldestPending = chrono::steady_clock::now();
+    }
+}
+
+bool NetworkJournal::flushLocked() {
+    if (fd < 0 || pending.empty()) return true;
+
+    size_t done = 0;
+    while (done < pending.size()) {
+        auto written = JOURNAL_WRITE(fd, pending.data() + done, (unsigned)(pending.size() - done));
+        if (written <= 0) {
+            // Keep only the unwritten bytes so a retry continues where
+            // this write stopped instead of duplicating records
+            bytesWritten += done;
+            pending.erase(0, done);
+            return false;
+        }
+        done += (size_t)written;
+    }
+
+    bytesWritten += pending.size();
+    pending.clear();
+    pendingRecords = 0;
+    return !policy.fsyncOnFlush || JOURNAL_SYNC(fd) == 0;
+}
+
+bool NetworkJournal::reset() {
+    lock_guard<mutex> guard(lock);
+    if (fd < 0) return true;    // Nothing has been journaled
+    pending.clear();
+    pendingRecords = 0;
+    bytesWritten = 0;
+    if (JOURNAL_TRUNCATE(fd, 0) != 0) return false;
+    JOURNAL_SEEK_END(fd);
+    return JOURNAL_SYNC(fd) == 0;
+}
+
+uint64_t NetworkJournal::size() const {
+    lock_guard<mutex> guard(lock);
+    return bytesWritten + pending.size();
+}
+
+void NetworkJournal::setSyncPolicy(const JournalSyncPolicy& policy) {
+    lock_guard<mutex> guard(lock);
+    this->policy = policy;
+    wake.notify_one();              // The deadline may have moved
+}
+
+JournalSyncPolicy NetworkJournal::getSyncPolicy() const {
+    lock_guard<mutex> guard(lock);
+    return policy;
+}
@@ -0,0 +1,104 @@
+/**
+ * Network Journal Header
+ *
+ * Append-only log of network mutations written between full saves, so
+ * persisting one change costs one small record instead of rewriting every
+ * file. Each record is framed as
+ *
+ *   uint32 payloadLength | uint32 crc32(payload) | payload
+ *
+ * Records are buffered and written (and fsync'd) in batches according to
+ * the sync policy. While the journal is open a flusher thread writes the
+ * buffer once its oldest record is maxDelayMs old, so the delay bound
+ * holds even when no further change arrives. On startup the journal is replayed on top of the last
+ * snapshot; replay stops at the first torn or corrupt record and the tail
+ * after it is truncated.
+ */
+
+#ifndef NETWORK_JOURNAL_H
+#define NETWORK_JOURNAL_H
+
+#include <cstdint>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+enum class JournalOp : uint8_t {
+    AddHospital = 1,
+    UpdateHospital = 2,
+    DeleteHospital = 3,
+    AddConnection = 4,
+    RemoveConnection = 5,
+    DeleteAllHospitals = 6,
+    DeleteAllConnections = 7
+};
+
+struct JournalRecord {
+    JournalOp op = JournalOp::AddHospital;
+    string id;
+    string otherId;             // Second hospital of a connection
+    string name;
+    string location;
+    string description;
+    int patientCount = 0;
+    double distance = 0.0;
+};
+
+// When buffered records are written and fsync'd
+struct JournalSyncPolicy {
+    size_t maxPendingRecords = 64;      // Flush after this many records
+    long long maxDelayMs = 200;         // ...or once the oldest is this old
+    bool fsyncOnFlush = true;           // fsync after every flush
+};
+
+class NetworkJournal {
+public:
+    NetworkJournal();
+    ~NetworkJournal();
+
+    NetworkJournal(const NetworkJournal&) = delete;
+    NetworkJournal& operator=(const NetworkJournal&) = delete;
+
+    // Apply every intact record in order; returns the byte length of the
+    // intact prefix (the rest is a torn or corrupt tail)
+    static uint64_t replay(const string& filename,
+                           const function<void(const JournalRecord&)>& apply);
+
+    // Open for appending, dropping anything after validLength
+    bool open(const string& filename, uint64_t validLength);
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+    bool append(const JournalRecord& record);
+    bool flush();                       // Write pending records and sync
+    bool reset();                       // Empty the journal after compaction
+    uint64_t size() const;
+
+    void setSyncPolicy(const JournalSyncPolicy& policy);
+    JournalSyncPolicy getSyncPolicy() const;
+
+private:
+    mutable mutex lock;                 // Guards everything below
+    condition_variable wake;            // Signals the flusher
+    thread flusher;
+    bool stopping;
+    int fd;
+    string pending;                     // Encoded records not yet written
+    size_t pendingRecords;
+    uint64_t bytesWritten;
+    chrono::steady_clock::time_point oldestPending;
+    JournalSyncPolicy policy;
+
+    bool flushLocked();
+    void flushWhenDue();                // Flusher thread body
+
+    static string encode(const JournalRecord& record);
+    static bool decode(const char* data, size_t length, JournalRecord& record);
+};
+
+#endif // NETWORK_JOURNAL_H
@@ -0,0 +1,235 @@
+#include "network_metrics.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+const int LatencyHistogram::SUB_BUCKET_BITS;
+const int LatencyHistogram::SUB_BUCKETS;
+const int LatencyHistogram::MAGNITUDES;
+const int LatencyHistogram::BUCKETS;
+
+// Histogram
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+// Values below SUB_BUCKETS get a bucket each; above that, bucket k holds
+// the 32 linear steps of [2^(k+4), 2^(k+5))
+int LatencyHistogram::bucketOf(uint64_t nanos) {
+    const uint64_t largest = (1ULL << (MAGNITUDES + SUB_BUCKET_BITS)) - 1;
+    if (nanos > largest) nanos = largest;
+    if (nanos < (uint64_t)SUB_BUCKETS) return (int)nanos;
+
+    int magnitude = 63 - __builtin_clzll(nanos);
+    int shift = magnitude - SUB_BUCKET_BITS;
+    int sub = (int)(nanos >> shift) - SUB_BUCKETS;
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::highestValueIn(int bucket) {
+    if (bucket < SUB_BUCKETS) return (uint64_t)bucket;
+
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t lowest = (uint64_t)(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lowest + (1ULL << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets[bucketOf(nanos)].fetch_add(1, memory_order_relaxed);
+    count.fetch_add(1, memory_order_relaxed);
+    sum.fetch_add(nanos, memory_order_relaxed);
+
+    uint64_t seen = max.load(memory_order_relaxed);
+    while (nanos > seen && !max.compare_exchange_weak(seen, nanos, memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets) bucket.store(0, memory_order_relaxed);
+    count.store(0, memory_order_relaxed);
+    sum.store(0, memory_order_relaxed);
+    max.store(0, memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getCount() const {
+    return count.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMax() const {
+    return max.load(memory_order_relaxed);
+}
+
+double LatencyHistogram::getMean() const {
+    uint64_t calls = getCount();
+    return calls ? (double)sum.load(memory_order_relaxed) / calls : 0.0;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    uint64_t calls = getCount();
+    if (calls == 0) return 0;
+
+    uint64_t rank = (uint64_t)(p / 100.0 * calls + 0.999999);
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += buckets[b].load(memory_order_relaxed);
+        if (seen >= rank) return min(highestValueIn(b), getMax());
+    }
+    return getMax();
+}
+
+// Metrics
+NetworkMetrics::NetworkMetrics() {
+    reset();
+}
+
+const char* NetworkMetrics::name(MetricOp op) {
+    switch (op) {
+        case MetricOp::AddHospital: return "addHospital";
+        case MetricOp::UpdateHospital: return "updateHospital";
+        case MetricOp::SetPatientCount: return "setPatientCount";
+        case MetricOp::DeleteHospital: return "deleteHospital";
+        case MetricOp::DeleteHospitals: return "deleteHospitals";
+        case MetricOp::DeleteAllHospitals: return "deleteAllHospitals";
+        case MetricOp::AddConnection: return "addConnection";
+        case MetricOp::RemoveConnection: return "removeConnection";
+        case MetricOp::DeleteAllConnections: return "deleteAllConnections";
+        case MetricOp::CommitBatch: return "commitBatch";
+        case MetricOp::ShortestPath: return "findShortestPath";
+        case MetricOp::LongestPath: return "findLongestPath";
+        case MetricOp::NearestWithCapacity: return "findNearestWithCapacity";
+        case MetricOp::DistanceMatrix: return "computeDistanceMatrix";
+        case MetricOp::BuildHierarchy: return "buildContractionHierarchy";
+        case MetricOp::DisplayAllHospitals: return "displayAllHospitals";
+        case MetricOp::DisplayConnections: return "displayConnections";
+        case MetricOp::DisplayShortestPath: return "displayShortestPath";
+        case MetricOp::DisplayLongestPath: return "displayLongestPath";
+        case MetricOp::DisplayNearestWithCapacity: return "displayNearestWithCapacity";
+        case MetricOp::DisplayDistances: return "displayDistances";
+        case MetricOp::DisplayComponents: return "displayComponents";
+        case MetricOp::DisplayConnectivity: return "displayConnectivity";
+        case MetricOp::ExportRelationships: return "exportRelationships";
+        case MetricOp::GenerateDiagram: return "generateNetworkDiagram";
+        case MetricOp::SetupScenario: return "setupPredefinedScenario";
+        case MetricOp::LoadData: return "loadData";
+        case MetricOp::SaveData: return "saveData";
+        case MetricOp::ImportCSV: return "importCSV";
+        case MetricOp::LoadSnapshot: return "loadSnapshot";
+        case MetricOp::SaveSnapshot: return "saveSnapshot";
+        case MetricOp::CompactJournal: return "compactJournal";
+        case MetricOp::SyncJournal: return "syncJournal";
+        case MetricOp::Count: break;
+    }
+    return "unknown";
+}
+
+void NetworkMetrics::record(MetricOp op, uint64_t nanos) {
+    operations[(int)op].latency.record(nanos);
+}
+
+void NetworkMetrics::addSearchWork(MetricOp op, long long verticesSettled, long long edgesRelaxed) {
+    Operation& operation = operations[(int)op];
+    operation.verticesSettled.fetch_add((uint64_t)verticesSettled, memory_order_relaxed);
+    operation.edgesRelaxed.fetch_add((uint64_t)edgesRelaxed, memory_order_relaxed);
+}
+
+void NetworkMetrics::reset() {
+    for (auto& operation : operations) {
+        operation.latency.reset();
+        operation.verticesSettled.store(0, memory_order_relaxed);
+        operation.edgesRelaxed.store(0, memory_order_relaxed);
+    }
+    resetPathCache();
+}
+
+const LatencyHistogram& NetworkMetrics::getLatency(MetricOp op) const {
+    return operations[(int)op].latency;
+}
+
+uint64_t NetworkMetrics::getVerticesSettled(MetricOp op) const {
+    return operations[(int)op].verticesSettled.load(memory_order_relaxed);
+}
+
+uint64_t NetworkMetrics::getEdgesRelaxed(MetricOp op) const {
+    return operations[(int)op].edgesRelaxed.load(memory_order_relaxed);
+}
+
+void NetworkMetrics::recordPathCacheLookup(bool hit) {
+    (hit ? pathCacheHits : pathCacheMisses).fetch_add(1, memory_order_relaxed);
+}
+
+uint64_t NetworkMetrics::getPathCacheHits() const {
+    return pathCacheHits.load(memory_order_relaxed);
+}
+
+uint64_t NetworkMetrics::getPathCacheMisses() const {
+    return pathCacheMisses.load(memory_order_relaxed);
+}
+
+void NetworkMetrics::resetPathCache() {
+    pathCacheHits.store(0, memory_order_relaxed);
+    pathCacheMisses.store(0, memory_order_relaxed);
+}
+
+// Report
+void NetworkMetrics::print(ostream& out) const {
+    out << left << setw(28) << "Operation" << right
+        << setw(10) << "Calls" << setw(12) << "p50 (us)" << setw(12) << "p99 (us)"
+        << setw(12) << "Max (us)" << setw(14) << "Settled" << setw(14) << "Relaxed" << "\n";
+    out << string(102, '-') << "\n";
+
+    out << fixed << setprecision(1);
+    bool any = false;
+    for (int i = 0; i < (int)MetricOp::Count; i++) {
+        const LatencyHistogram& latency = operations[i].latency;
+        if (latency.getCount() == 0) continue;
+        any = true;
+        out << left << setw(28) << name((MetricOp)i) << right
+            << setw(10) << latency.getCount()
+            << setw(12) << latency.percentile(50) / 1000.0
+            << setw(12) << latency.percentile(99) / 1000.0
+            << setw(12) << latency.getMax() / 1000.0
+            << setw(14) << getVerticesSettled((MetricOp)i)
+            << setw(14) << getEdgesRelaxed((MetricOp)i) << "\n";
+    }
+    out << defaultfloat;
+    if (!any) out << "No operations recorded yet.\n";
+    if (getPathCacheHits() + getPathCacheMisses() > 0) {
+        out << "Path cache: " << getPathCacheHits() << " hits, "
+            << getPathCacheMisses() << " misses\n";
+    }
+}
+
+string NetworkMetrics::toJSON() const {
+    stringstream json;
+    json << "{\n  \"unit\": \"ns\",\n  \"operations\": {";
+    bool first = true;
+    for (int i = 0; i < (int)MetricOp::Count; i++) {
+        const LatencyHistogram& latency = operations[i].latency;
+        if (latency.getCount() == 0) continue;
+        json << (first ? "\n" : ",\n");
+        first = false;
+        json << "    \"" << name((MetricOp)i) << "\": {"
+             << "\"calls\": " << latency.getCount()
+             << ", \"mean\": " << (uint64_t)latency.getMean()
+             << ", \"p50\": " << latency.percentile(50)
+             << ", \"p90\": " << latency.percentile(90)
+             << ", \"p99\": " << latency.percentile(99)
+             << ", \"p999\": " << latency.percentile(99.9)
+             << ", \"max\": " << latency.getMax()
+             << ", \"vertices_settled\": " << getVerticesSettled((MetricOp)i)
+             << ", \"edges_relaxed\": " << getEdgesRelaxed((MetricOp)i) << "}";
+    }
+    json << (first ? "}" : "\n  }");
+    json << ",\n  \"path_cache\": {\"hits\": " << getPathCacheHits()
+         << ", \"misses\": " << getPathCacheMisses() << "}\n}\n";
+    return json.str();
+}
+
+bool NetworkMetrics::exportJSON(const string& filename) const {
+    ofstream file(filename);
+    if (!file.is_open()) return false;
+    file << toJSON();
+    return file.good();
+}
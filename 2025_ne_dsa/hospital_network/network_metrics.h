@@ -0,0 +1,152 @@
+/**
+ * Network Metrics Header
+ *
+ * Always-on instrumentation for HospitalNetwork: a call count and latency
+ * histogram per operation, plus the vertices settled and edges relaxed by
+ * path queries, and the hit/miss totals of every thread's shortest-path
+ * cache.
+ *
+ * Histograms use HdrHistogram-style log-linear buckets: every power of two
+ * is split into 32 linear steps, so a percentile is reported to within
+ * about 3% of the true value while recording stays a couple of relaxed
+ * atomic adds. Any thread may record at any time without locking.
+ */
+
+#ifndef NETWORK_METRICS_H
+#define NETWORK_METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+using namespace std;
+
+enum class MetricOp {
+    // Hospitals
+    AddHospital,
+    UpdateHospital,
+    SetPatientCount,
+    DeleteHospital,
+    DeleteHospitals,
+    DeleteAllHospitals,
+    // Connections
+    AddConnection,
+    RemoveConnection,
+    DeleteAllConnections,
+    CommitBatch,
+    // Queries
+    ShortestPath,
+    LongestPath,
+    NearestWithCapacity,
+    DistanceMatrix,
+    BuildHierarchy,
+    // Display and export
+    DisplayAllHospitals,
+    DisplayConnections,
+    DisplayShortestPath,
+    DisplayLongestPath,
+    DisplayNearestWithCapacity,
+    DisplayDistances,
+    DisplayComponents,
+    DisplayConnectivity,
+    ExportRelationships,
+    GenerateDiagram,
+    SetupScenario,
+    // Persistence
+    LoadData,
+    SaveData,
+    ImportCSV,
+    LoadSnapshot,
+    SaveSnapshot,
+    CompactJournal,
+    SyncJournal,
+    Count
+};
+
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 5;           // 32 steps per power of two
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int MAGNITUDES = 40;               // Up to 2^45 ns (about 10 hours)
+    static const int BUCKETS = SUB_BUCKETS * (MAGNITUDES + 1);
+
+    LatencyHistogram();
+
+    void record(uint64_t nanos);
+    void reset();
+
+    uint64_t getCount() const;
+    uint64_t getMax() const;
+    double getMean() const;
+    uint64_t percentile(double p) const;            // Nanoseconds, p in 0..100
+
+private:
+    atomic<uint64_t> buckets[BUCKETS];
+    atomic<uint64_t> count;
+    atomic<uint64_t> sum;
+    atomic<uint64_t> max;
+
+    static int bucketOf(uint64_t nanos);
+    static uint64_t highestValueIn(int bucket);
+};
+
+class NetworkMetrics {
+public:
+    NetworkMetrics();
+
+    static const char* name(MetricOp op);
+
+    void record(MetricOp op, uint64_t nanos);
+    void addSearchWork(MetricOp op, long long verticesSettled, long long edgesRelaxed);
+    void reset();
+
+    const LatencyHistogram& getLatency(MetricOp op) const;
+    uint64_t getVerticesSettled(MetricOp op) const;
+    uint64_t getEdgesRelaxed(MetricOp op) const;
+
+    // Shortest-path cache lookups, summed over all threads
+    void recordPathCacheLookup(bool hit);
+    uint64_t getPathCacheHits() const;
+    uint64_t getPathCacheMisses() const;
+    void resetPathCache();
+
+    // Operations that were never called are left out
+    void print(ostream& out) const;
+    string toJSON() const;
+    bool exportJSON(const string& filename) const;
+
+private:
+    struct Operation {
+        LatencyHistogram latency;
+        atomic<uint64_t> verticesSettled;
+        atomic<uint64_t> edgesRelaxed;
+    };
+    Operation operations[(int)MetricOp::Count];
+    atomic<uint64_t> pathCacheHits;
+    atomic<uint64_t> pathCacheMisses;
+};
+
+// Records the lifetime of a scope as one call. Inline, since it wraps
+// every instrumented method.
+class MetricTimer {
+public:
+    MetricTimer(NetworkMetrics& metrics, MetricOp op)
+        : metrics(metrics), op(op), start(chrono::steady_clock::now()) {}
+
+    ~MetricTimer() {
+        auto elapsed = chrono::steady_clock::now() - start;
+        metrics.record(op, (uint64_t)chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+    }
+
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+private:
+    NetworkMetrics& metrics;
+    MetricOp op;
+    chrono::steady_clock::time_point start;
+};
+
+#endif // NETWORK_METRICS_H
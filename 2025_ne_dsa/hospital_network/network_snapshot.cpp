@@ -0,0 +1,187 @@
+#include "network_snapshot.h"
+#include "file_sync.h"
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+const uint32_t NetworkSnapshot::FORMAT_VERSION;
+
+static const char SNAPSHOT_MAGIC[8] = {'H', 'N', 'S', 'N', 'A', 'P', 0, 0};
+
+static uint64_t alignTo8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+// Writing
+bool NetworkSnapshot::write(const string& filename, const map<string, Hospital>& hospitals) {
+    // Deduplicated string table
+    string table;
+    unordered_map<string, SnapshotString> interned;
+    auto intern = [&](const string& value) {
+        auto it = interned.find(value);
+        if (it != interned.end()) return it->second;
+        SnapshotString ref = {(uint32_t)table.size(), (uint32_t)value.size()};
+        table += value;
+        interned[value] = ref;
+        return ref;
+    };
+
+    unordered_map<string, uint32_t> index;
+    for (const auto& pair : hospitals) {
+        uint32_t next = (uint32_t)index.size();
+        index[pair.first] = next;
+    }
+
+    vector<SnapshotHospital> records;
+    vector<uint32_t> offsets(1, 0);
+    vector<SnapshotEdge> edges;
+    records.reserve(hospitals.size());
+    offsets.reserve(hospitals.size() + 1);
+
+    for (const auto& pair : hospitals) {
+        const Hospital& hospital = pair.second;
+        SnapshotHospital record = {};
+        record.id = intern(hospital.getId());
+        record.name = intern(hospital.getName());
+        record.location = intern(hospital.getLocation());
+        record.patientCount = hospital.getPatientCount();
+        records.push_back(record);
+
+        for (const auto& conn : hospital.getConnectionView()) {
+            auto target = index.find(conn.first);
+            if (target == index.end()) continue;
+
+            SnapshotEdge edge = {};
+            edge.target = target->second;
+            edge.description = intern(conn.second.description);
+            edge.distance = conn.second.distance;
+            edges.push_back(edge);
+        }
+        offsets.push_back((uint32_t)edges.size());
+    }
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = FORMAT_VERSION;
+    header.hospitalCount = (uint32_t)records.size();
+    header.edgeCount = (uint32_t)edges.size();
+    header.stringBytes = (uint32_t)table.size();
+    header.stringsOffset = sizeof(SnapshotHeader);
+    header.hospitalsOffset = alignTo8(header.stringsOffset + table.size());
+    header.offsetsOffset = alignTo8(header.hospitalsOffset + records.size() * sizeof(SnapshotHospital));
+    header.edgesOffset = alignTo8(header.offsetsOffset + offsets.size() * sizeof(uint32_t));
+
+    // Write to a temporary file, then sync and rename it over the old snapshot
+    string tempName = filename + ".tmp";
+    ofstream out(tempName, ios::binary | ios::trunc);
+    if (!out.is_open()) return false;
+
+    auto padTo = [&](uint64_t position) {
+        static const char zeros[8] = {0};
+        uint64_t current = (uint64_t)out.tellp();
+        if (position > current) out.write(zeros, position - current);
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(table.data(), table.size());
+    padTo(header.hospitalsOffset);
+    out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(SnapshotHospital));
+    padTo(header.offsetsOffset);
+    out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+    padTo(header.edgesOffset);
+    out.write(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(SnapshotEdge));
+    out.close();
+    if (!out) {
+        remove(tempName.c_str());
+        return false;
+    }
+
+    return replaceFile(tempName, filename);
+}
+
+// Reading
+bool NetworkSnapshot::open(const string& filename) {
+    close();
+    if (!file.open(filename)) return false;
+    if (file.getSize() < sizeof(SnapshotHeader)) {
+        close();
+        return false;
+    }
+
+    const char* base = file.getData();
+    header = reinterpret_cast<const SnapshotHeader*>(base);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header->version != FORMAT_VERSION) {
+        close();
+        return false;
+    }
+
+    // Section bounds must fit before any pointer into them is formed
+    uint64_t size = file.getSize();
+    uint64_t n = header->hospitalCount;
+    if (header->stringsOffset + header->stringBytes > size ||
+        header->hospitalsOffset + n * sizeof(SnapshotHospital) > size ||
+        header->offsetsOffset + (n + 1) * sizeof(uint32_t) > size ||
+        header->edgesOffset + (uint64_t)header->edgeCount * sizeof(SnapshotEdge) > size ||
+        header->hospitalsOffset % 8 || header->offsetsOffset % 4 || header->edgesOffset % 8) {
+        close();
+        return false;
+    }
+
+    strings = base + header->stringsOffset;
+    hospitals = reinterpret_cast<const SnapshotHospital*>(base + header->hospitalsOffset);
+    offsets = reinterpret_cast<const uint32_t*>(base + header->offsetsOffset);
+    edges = reinterpret_cast<const SnapshotEdge*>(base + header->edgesOffset);
+
+    if (!validate()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void NetworkSnapshot::close() {
+    file.close();
+    header = nullptr;
+    strings = nullptr;
+    hospitals = nullptr;
+    offsets = nullptr;
+    edges = nullptr;
+}
+
+string_view NetworkSnapshot::text(const SnapshotString& ref) const {
+    return string_view(strings + ref.offset, ref.length);
+}
+
+// Every string reference, CSR offset and edge target must be in range.
+// IDs must be strictly increasing (and so unique), and each hospital's
+// edges in target order: loading appends in that order and relies on it.
+bool NetworkSnapshot::validate() const {
+    auto validString = [&](const SnapshotString& ref) {
+        return (uint64_t)ref.offset + ref.length <= header->stringBytes;
+    };
+
+    uint32_t n = header->hospitalCount;
+    if (offsets[0] != 0 || offsets[n] != header->edgeCount) return false;
+
+    for (uint32_t i = 0; i < n; i++) {
+        const SnapshotHospital& record = hospitals[i];
+        if (!validString(record.id) || !validString(record.name) ||
+            !validString(record.location) || offsets[i] > offsets[i + 1]) {
+            return false;
+        }
+        if (i > 0 && !(text(hospitals[i - 1].id) < text(record.id))) return false;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        for (uint32_t e = offsets[i]; e < offsets[i + 1]; e++) {
+            if (edges[e].target >= n || !validString(edges[e].description)) return false;
+            if (e > offsets[i] && edges[e - 1].target >= edges[e].target) return false;
+        }
+    }
+    return true;
+}
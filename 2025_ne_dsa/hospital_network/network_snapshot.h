@@ -0,0 +1,95 @@
+/**
+ * Network Snapshot Header
+ *
+ * Versioned binary image of the whole hospital network that is memory
+ * mapped read-only at startup instead of parsed line by line. Layout
+ * (native byte order, every section 8-byte aligned):
+ *
+ *   SnapshotHeader                      64 bytes
+ *   string table                        UTF-8 bytes, deduplicated
+ *   SnapshotHospital[hospitalCount]     sorted by ID, no duplicates
+ *   uint32 offsets[hospitalCount + 1]   CSR row starts into the edge array
+ *   SnapshotEdge[edgeCount]             neighbour, description, distance;
+ *                                       each row sorted by neighbour
+ *
+ * Strings are (offset, length) references into the string table, so
+ * opening a snapshot only validates bounds and does no copying.
+ */
+
+#ifndef NETWORK_SNAPSHOT_H
+#define NETWORK_SNAPSHOT_H
+
+#include "hospital.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+struct SnapshotString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotHeader {
+    char magic[8];              // "HNSNAP\0\0"
+    uint32_t version;
+    uint32_t hospitalCount;
+    uint32_t edgeCount;
+    uint32_t stringBytes;
+    uint64_t stringsOffset;
+    uint64_t hospitalsOffset;
+    uint64_t offsetsOffset;
+    uint64_t edgesOffset;
+    uint64_t reserved;
+};
+
+struct SnapshotHospital {
+    SnapshotString id;
+    SnapshotString name;
+    SnapshotString location;
+    int32_t patientCount;
+    uint32_t reserved;
+};
+
+struct SnapshotEdge {
+    uint32_t target;            // Index into the hospital array
+    uint32_t reserved;
+    SnapshotString description;
+    double distance;
+};
+
+class NetworkSnapshot {
+public:
+    static const uint32_t FORMAT_VERSION = 1;
+
+    // Write hospitals and their connections; replaces the file atomically
+    static bool write(const string& filename, const map<string, Hospital>& hospitals);
+
+    // Map a snapshot and validate every section, reference and ordering
+    bool open(const string& filename);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    uint32_t getHospitalCount() const { return header->hospitalCount; }
+    uint32_t getEdgeCount() const { return header->edgeCount; }
+    const SnapshotHospital& getHospital(uint32_t index) const { return hospitals[index]; }
+    uint32_t edgeBegin(uint32_t index) const { return offsets[index]; }
+    uint32_t edgeEnd(uint32_t index) const { return offsets[index + 1]; }
+    const SnapshotEdge& getEdge(uint32_t edge) const { return edges[edge]; }
+    string_view text(const SnapshotString& ref) const;
+
+private:
+    MappedFile file;
+    const SnapshotHeader* header = nullptr;
+    const char* strings = nullptr;
+    const SnapshotHospital* hospitals = nullptr;
+    const uint32_t* offsets = nullptr;
+    const SnapshotEdge* edges = nullptr;
+
+    bool validate() const;
+};
+
+#endif // NETWORK_SNAPSHOT_H
@@ -0,0 +1,196 @@
+#include "network_view.h"
+#include <algorithm>
+
+using namespace std;
+
+// Each reader thread has its own search buffers and tree cache, so
+// queries never share mutable state
+static thread_local PathWorkspace threadWorkspace;
+static thread_local PathCache threadCache;
+static thread_local PathWorkspace threadForward;
+static thread_local PathWorkspace threadBackward;
+
+NetworkView::NetworkView(const map<string, Hospital>& hospitals,
+                         shared_ptr<const StringPool> strings, const NetworkGraph& graph,
+                         NetworkComponents components, unsigned long long version,
+                         shared_ptr<NetworkMetrics> metrics,
+                         shared_ptr<const ContractionHierarchy> hierarchy)
+    : strings(move(strings)), hospitals(hospitals), graph(graph), components(move(components)), version(version),
+      metrics(move(metrics)), hierarchy(move(hierarchy)) {}
+
+unsigned long long NetworkView::getVersion() const {
+    return version;
+}
+
+const map<string, Hospital>& NetworkView::getHospitals() const {
+    return hospitals;
+}
+
+const NetworkGraph& NetworkView::getGraph() const {
+    return graph;
+}
+
+bool NetworkView::hasHierarchy() const {
+    return hierarchy != nullptr;
+}
+
+// Lookups
+const Hospital* NetworkView::findHospital(const string& id) const {
+    auto it = hospitals.find(id);
+    return (it != hospitals.end()) ? &(it->second) : nullptr;
+}
+
+bool NetworkView::hospitalExists(const string& id) const {
+    return hospitals.find(id) != hospitals.end();
+}
+
+bool NetworkView::connectionExists(const string& id1, const string& id2) const {
+    const Hospital* hospital = findHospital(id1);
+    return hospital && hospital->hasConnection(id2);
+}
+
+int NetworkView::patientCount(const string& id) const {
+    return graph.getLoadIndex().loadOf(graph.indexOf(id));
+}
+
+// Connectivity
+bool NetworkView::connected(const string& id1, const string& id2) const {
+    int a = graph.indexOf(id1);
+    int b = graph.indexOf(id2);
+    if (a == NetworkGraph::NO_VERTEX || b == NetworkGraph::NO_VERTEX) return false;
+    return components.label[a] != -1 && components.label[a] == components.label[b];
+}
+
+int NetworkView::componentCount() const {
+    return components.count();
+}
+
+vector<string> NetworkView::componentMembers(const string& id) const {
+    vector<string> members;
+    int v = graph.indexOf(id);
+    if (v == NetworkGraph::NO_VERTEX || components.label[v] == -1) return members;
+
+    int c = components.label[v];
+    for (int m = components.offsets[c]; m < components.offsets[c + 1]; m++) {
+        members.push_back(graph.idOf(components.members[m]));
+    }
+    sort(members.begin(), members.end());
+    return members;
+}
+
+const NetworkComponents& NetworkView::getComponents() const {
+    return components;
+}
+
+// Path queries
+vector<string> NetworkView::shortestPath(const string& start, const string& end) const {
+    MetricTimer timer(*metrics, MetricOp::ShortestPath);
+    if (!hospitalExists(start) || !hospitalExists(end)) {
+        return vector<string>();
+    }
+
+    int source = graph.indexOf(start);
+    int target = graph.indexOf(end);
+    vector<string> path;
+
+    // Hospitals added after the hierarchy was built have no connections
+    // yet; those queries fall through to Dijkstra
+    if (hierarchy && source < hierarchy->vertexCount() && target < hierarchy->vertexCount()) {
+        double distance;
+        vector<int> vertices = hierarchy->shortestPath(source, target, threadForward,
+                                                       threadBackward, distance);
+        metrics->addSearchWork(MetricOp::ShortestPath,
+                               threadForward.settled + threadBackward.settled,
+                               threadForward.relaxed + threadBackward.relaxed);
+        for (int v : vertices) {
+            path.push_back(graph.idOf(v));
+        }
+        return path;
+    }
+
+    // Repeat sources reuse their cached shortest-path tree. A cold source
+    // gets a search that stops at the target; the full tree is only built
+    // once the source has been asked for again.
+    const ShortestPathTree* tree = threadCache.find(source, version);
+    metrics->recordPathCacheLookup(tree != nullptr);
+    if (!tree && !threadCache.isHot(source)) {
+        graph.shortestPaths(source, target, threadWorkspace);
+        metrics->addSearchWork(MetricOp::ShortestPath, threadWorkspace.settled,
+                               threadWorkspace.relaxed);
+        for (int v : NetworkGraph::extractPath(threadWorkspace, target)) {
+            path.push_back(graph.idOf(v));
+        }
+        return path;
+    }
+    if (!tree) {
+        graph.shortestPaths(source, NetworkGraph::NO_VERTEX, threadWorkspace);
+        metrics->addSearchWork(MetricOp::ShortestPath, threadWorkspace.settled,
+                               threadWorkspace.relaxed);
+        ShortestPathTree fresh;
+        fresh.source = source;
+        fresh.dist = threadWorkspace.dist;
+        fresh.prev = threadWorkspace.prev;
+        tree = threadCache.insert(move(fresh), version);
+    }
+
+    for (int v : NetworkGraph::extractPath(tree->dist, tree->prev, target)) {
+        path.push_back(graph.idOf(v));
+    }
+    return path;
+}
+
+vector<string> NetworkView::longestPath(const string& start, const string& end,
+                                        const SearchBudget& budget, bool& complete) const {
+    MetricTimer timer(*metrics, MetricOp::LongestPath);
+    complete = true;
+    if (!hospitalExists(start) || !hospitalExists(end)) {
+        return vector<string>();
+    }
+
+    LongestPathSearch search(graph, budget);
+    LongestPathResult result = search.find(graph.indexOf(start), graph.indexOf(end));
+    complete = result.complete;
+    metrics->addSearchWork(MetricOp::LongestPath, result.nodesExpanded, result.edgesScanned);
+
+    vector<string> path;
+    for (int v : result.path) {
+        path.push_back(graph.idOf(v));
+    }
+    return path;
+}
+
+vector<NearbyHospital> NetworkView::nearestWithCapacity(const string& origin, int k,
+                                                        int threshold) const {
+    MetricTimer timer(*metrics, MetricOp::NearestWithCapacity);
+    vector<NearbyHospital> result;
+    int source = graph.indexOf(origin);
+    if (source == NetworkGraph::NO_VERTEX) return result;
+
+    vector<int> found = graph.nearestWithCapacity(source, k, threshold, threadWorkspace);
+    metrics->addSearchWork(MetricOp::NearestWithCapacity, threadWorkspace.settled,
+                           threadWorkspace.relaxed);
+    for (int v : found) {
+        result.push_back({graph.idOf(v), threadWorkspace.dist[v], graph.getLoadIndex().loadOf(v)});
+    }
+    return result;
+}
+
+// Sum of connection distances along a path
+double NetworkView::pathDistance(const vector<string>& path) const {
+    double total = 0;
+    for (size_t i = 0; i + 1 < path.size(); i++) {
+        const Hospital* hospital = findHospital(path[i]);
+        if (hospital) {
+            total += hospital->getConnectionDistance(path[i + 1]);
+        }
+    }
+    return total;
+}
+
+PathCacheStats NetworkView::getThreadCacheStats() {
+    return threadCache.getStats();
+}
+
+void NetworkView::resetThreadCacheStats() {
+    threadCache.resetStats();
+}
@@ -0,0 +1,98 @@
+/**
+ * Network View Header
+ *
+ * An immutable copy of the hospitals and their CSR graph. HospitalNetwork
+ * publishes a fresh view on the first read after committed changes (one
+ * copy however many changes came before it) and swaps it in RCU style:
+ * readers keep the view they picked up through a shared_ptr, so path and
+ * lookup queries can run on any number of threads without locks while a
+ * writer changes the live network. An old view is freed when its last
+ * reader lets go of it.
+ *
+ * Patient counts are the exception to the copy: the view shares the live
+ * graph's load index, so a setPatientCount shows up in nearestWithCapacity
+ * and patientCount() without a new view. The Hospital copies keep the
+ * count they had when the view was built.
+ *
+ * Path queries are timed into the owning network's metrics, which the
+ * view shares so they stay valid for as long as the view does. When the
+ * network has a contraction hierarchy for this exact graph, shortest
+ * paths use it instead of a full Dijkstra search.
+ */
+
+#ifndef NETWORK_VIEW_H
+#define NETWORK_VIEW_H
+
+#include "hospital.h"
+#include "network_graph.h"
+#include "longest_path.h"
+#include "path_cache.h"
+#include "network_metrics.h"
+#include "contraction_hierarchy.h"
+#include "connectivity_index.h"
+#include "string_pool.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// One answer of a nearest-with-capacity query
+struct NearbyHospital {
+    string id;
+    double distance;
+    int patientCount;
+};
+
+class NetworkView {
+public:
+    NetworkView(const map<string, Hospital>& hospitals, shared_ptr<const StringPool> strings,
+                const NetworkGraph& graph,
+                NetworkComponents components, unsigned long long version, shared_ptr<NetworkMetrics> metrics,
+                shared_ptr<const ContractionHierarchy> hierarchy = nullptr);
+
+    // Version is unique across all networks in the process
+    unsigned long long getVersion() const;
+    const map<string, Hospital>& getHospitals() const;
+    const NetworkGraph& getGraph() const;
+    bool hasHierarchy() const;
+
+    // Lookups
+    const Hospital* findHospital(const string& id) const;
+    bool hospitalExists(const string& id) const;
+    bool connectionExists(const string& id1, const string& id2) const;
+    int patientCount(const string& id) const;      // Current load, -1 if unknown
+    
+    // Reachability without a path search; members are sorted by ID
+    bool connected(const string& id1, const string& id2) const;
+    int componentCount() const;
+    vector<string> componentMembers(const string& id) const;
+    const NetworkComponents& getComponents() const;
+
+    // Path queries; an empty path means there is no route
+    vector<string> shortestPath(const string& start, const string& end) const;
+    vector<string> longestPath(const string& start, const string& end,
+                               const SearchBudget& budget, bool& complete) const;
+    double pathDistance(const vector<string>& path) const;
+
+    // Up to k hospitals closest to origin with fewer than threshold
+    // patients, nearest first (origin itself excluded)
+    vector<NearbyHospital> nearestWithCapacity(const string& origin, int k, int threshold) const;
+
+    // Shortest-path trees are cached per thread, keyed by view version;
+    // lookups are also counted in the shared NetworkMetrics
+    static PathCacheStats getThreadCacheStats();
+    static void resetThreadCacheStats();
+
+private:
+    const shared_ptr<const StringPool> strings;    // Text of the hospitals below
+    const map<string, Hospital> hospitals;
+    const NetworkGraph graph;
+    const NetworkComponents components;
+    const unsigned long long version;
+    const shared_ptr<NetworkMetrics> metrics;
+    const shared_ptr<const ContractionHierarchy> hierarchy;   // May be null
+};
+
+#endif // NETWORK_VIEW_H
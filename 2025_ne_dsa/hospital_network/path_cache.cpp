@@ -0,0 +1,76 @@
+#include "path_cache.h"
+#include <utility>
+
+using namespace std;
+
+const int PathCache::HOT_MISSES;
+
+PathCache::PathCache(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+const ShortestPathTree* PathCache::find(int source, unsigned long long current) {
+    syncVersion(current);
+
+    auto it = bySource.find(source);
+    if (it == bySource.end()) {
+        misses++;
+        // Forget old counts rather than let one-off sources pile up
+        if (missesBySource.size() >= capacity * 16) missesBySource.clear();
+        missesBySource[source]++;
+        return nullptr;
+    }
+
+    // Move to the front of the LRU list
+    trees.splice(trees.begin(), trees, it->second);
+    hits++;
+    return &trees.front();
+}
+
+bool PathCache::isHot(int source) const {
+    auto it = missesBySource.find(source);
+    return it != missesBySource.end() && it->second >= HOT_MISSES;
+}
+
+const ShortestPathTree* PathCache::insert(ShortestPathTree tree, unsigned long long current) {
+    syncVersion(current);
+
+    auto existing = bySource.find(tree.source);
+    if (existing != bySource.end()) {
+        trees.erase(existing->second);
+        bySource.erase(existing);
+    }
+
+    while (trees.size() >= capacity) {
+        bySource.erase(trees.back().source);
+        trees.pop_back();
+    }
+
+    trees.push_front(move(tree));
+    bySource[trees.front().source] = trees.begin();
+    return &trees.front();
+}
+
+void PathCache::clear() {
+    trees.clear();
+    bySource.clear();
+    missesBySource.clear();
+}
+
+PathCacheStats PathCache::getStats() const {
+    PathCacheStats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.entries = trees.size();
+    return stats;
+}
+
+void PathCache::resetStats() {
+    hits = 0;
+    misses = 0;
+}
+
+void PathCache::syncVersion(unsigned long long current) {
+    if (current != version) {
+        clear();
+        version = current;
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * Path Cache Header
+ *
+ * Keeps the shortest-path tree of recently queried source hospitals so a
+ * repeated query only walks predecessor links. Every entry is tagged with
+ * the graph version it was computed on; once HospitalNetwork bumps its
+ * version the whole cache is dropped on the next lookup.
+ *
+ * Least recently used sources are evicted when the cache is full.
+ *
+ * A full tree costs a search of the whole network, so it is only worth
+ * building for a hot source: one that has already missed at the current
+ * version. The first query from a source runs a point-to-point search
+ * that stops at its target instead.
+ */
+
+#ifndef PATH_CACHE_H
+#define PATH_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Distances and predecessors from one source to every vertex
+struct ShortestPathTree {
+    int source = -1;
+    vector<double> dist;
+    vector<int> prev;
+};
+
+struct PathCacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    size_t entries = 0;
+};
+
+class PathCache {
+public:
+    explicit PathCache(size_t capacity = 64);
+
+    // Tree for source at the given graph version, or nullptr on a miss
+    const ShortestPathTree* find(int source, unsigned long long version);
+
+    // True when source has missed at least HOT_MISSES times at the
+    // version seen by the last find
+    bool isHot(int source) const;
+
+    // Store a freshly computed tree and return the cached copy
+    const ShortestPathTree* insert(ShortestPathTree tree, unsigned long long version);
+
+    void clear();
+    PathCacheStats getStats() const;
+    void resetStats();
+
+private:
+    size_t capacity;
+    unsigned long long version = 0;
+    list<ShortestPathTree> trees;                                   // Most recent first
+    unordered_map<int, list<ShortestPathTree>::iterator> bySource;
+    long long hits = 0;
+    long long misses = 0;
+
+    // Misses per source at the current version (bounded, see find)
+    static const int HOT_MISSES = 2;
+    unordered_map<int, int> missesBySource;
+
+    void syncVersion(unsigned long long current);
+};
+
+#endif // PATH_CACHE_H
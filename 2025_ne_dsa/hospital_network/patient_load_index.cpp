@@ -0,0 +1,100 @@
+#include "patient_load_index.h"
+#include <algorithm>
+
+using namespace std;
+
+const int PatientLoadIndex::EXACT_LOADS;
+const int PatientLoadIndex::NO_LOAD;
+
+PatientLoadIndex::Storage::Storage(int capacity)
+    : capacity(capacity), loads(new atomic<int>[capacity]), total(0) {
+    for (auto& bucket : tree) bucket.store(0, memory_order_relaxed);
+}
+
+void PatientLoadIndex::clear() {
+    storage.reset();
+    count = 0;
+}
+
+int PatientLoadIndex::bucketOf(int load) {
+    return load < EXACT_LOADS ? load : EXACT_LOADS;
+}
+
+// Copy into new storage when a published copy still uses this one, or
+// when it is full. use_count only drops behind our back (a view being
+// freed), so at worst this copies once more than it needs to.
+void PatientLoadIndex::own(int capacity) {
+    if (storage && storage.use_count() == 1 && storage->capacity >= capacity) return;
+
+    int size = max(capacity, storage ? storage->capacity : 0);
+    if (size > (storage ? storage->capacity : 0)) size = max(16, size * 2);
+    auto fresh = make_shared<Storage>(size);
+    if (storage) {
+        for (int v = 0; v < count; v++) {
+            fresh->loads[v].store(storage->loads[v].load(memory_order_relaxed), memory_order_relaxed);
+        }
+        for (int i = 0; i < EXACT_LOADS + 2; i++) {
+            fresh->tree[i].store(storage->tree[i].load(memory_order_relaxed), memory_order_relaxed);
+        }
+        fresh->total.store(storage->total.load(memory_order_relaxed), memory_order_relaxed);
+    }
+    storage = move(fresh);
+}
+
+void PatientLoadIndex::add(int bucket, int delta) {
+    for (int i = bucket + 1; i < EXACT_LOADS + 2; i += i & -i) {
+        storage->tree[i].fetch_add(delta, memory_order_relaxed);
+    }
+    storage->total.fetch_add(delta, memory_order_relaxed);
+}
+
+int PatientLoadIndex::prefix(int buckets) const {
+    int total = 0;
+    if (!storage) return 0;
+    for (int i = buckets; i > 0; i -= i & -i) {
+        total += storage->tree[i].load(memory_order_relaxed);
+    }
+    return total;
+}
+
+// Updates
+void PatientLoadIndex::addVertex(int load) {
+    own(count + 1);
+    storage->loads[count].store(load, memory_order_relaxed);
+    count++;
+    if (load >= 0) add(bucketOf(load), 1);
+}
+
+// In place, so copies in published views see the new load
+void PatientLoadIndex::set(int vertex, int load) {
+    int old = loadOf(vertex);
+    if (old == NO_LOAD || load < 0) return;
+    add(bucketOf(old), -1);
+    storage->loads[vertex].store(load, memory_order_relaxed);
+    add(bucketOf(load), 1);
+}
+
+void PatientLoadIndex::remove(int vertex) {
+    int old = loadOf(vertex);
+    if (old == NO_LOAD) return;
+    own(count);
+    add(bucketOf(old), -1);
+    storage->loads[vertex].store(NO_LOAD, memory_order_relaxed);
+}
+
+// Queries
+int PatientLoadIndex::loadOf(int vertex) const {
+    if (vertex < 0 || vertex >= count) return NO_LOAD;
+    return storage->loads[vertex].load(memory_order_relaxed);
+}
+
+bool PatientLoadIndex::hasCapacity(int vertex, int threshold) const {
+    int load = loadOf(vertex);
+    return load != NO_LOAD && load < threshold;
+}
+
+int PatientLoadIndex::countBelow(int threshold) const {
+    if (threshold <= 0 || !storage) return 0;
+    if (threshold > EXACT_LOADS) return storage->total.load(memory_order_relaxed);
+    return prefix(threshold);
+}
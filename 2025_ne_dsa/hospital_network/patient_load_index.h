@@ -0,0 +1,65 @@
+/**
+ * Patient Load Index Header
+ *
+ * Patient count per graph vertex, kept next to the CSR arrays so a search
+ * can test whether a hospital has spare capacity with one array read.
+ * A Fenwick tree over the load values answers "how many hospitals carry
+ * fewer than T patients" in O(log L), which lets a nearest-hospital search
+ * stop as soon as every qualifying hospital has been found.
+ *
+ * Loads below EXACT_LOADS are counted exactly; higher loads share one
+ * overflow bucket, so counts for larger thresholds are an upper bound.
+ * Every update (set, add, remove) is O(log L).
+ *
+ * Copies share their storage, so the copy inside a published NetworkView
+ * sees set() on the live graph at once and a patient-count change needs
+ * no new view. Loads are relaxed atomics, so readers may run alongside
+ * the single writer. addVertex and remove first give the live index its
+ * own storage when a copy still shares it: structural changes wait for
+ * the next view like everything else. clear() also starts fresh storage.
+ */
+
+#ifndef PATIENT_LOAD_INDEX_H
+#define PATIENT_LOAD_INDEX_H
+
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+class PatientLoadIndex {
+public:
+    static const int EXACT_LOADS = 4096;
+    static const int NO_LOAD = -1;          // Removed vertex
+
+    void clear();
+    void addVertex(int load);
+    void set(int vertex, int load);
+    void remove(int vertex);
+
+    int loadOf(int vertex) const;
+    bool hasCapacity(int vertex, int threshold) const;      // 0 <= load < threshold
+
+    // Vertices with load below threshold (upper bound past EXACT_LOADS)
+    int countBelow(int threshold) const;
+
+private:
+    struct Storage {
+        explicit Storage(int capacity);
+
+        int capacity;
+        unique_ptr<atomic<int>[]> loads;    // Per vertex
+        atomic<int> tree[EXACT_LOADS + 2];  // Fenwick tree, EXACT_LOADS + 1 buckets
+        atomic<int> total;
+    };
+
+    shared_ptr<Storage> storage;            // Shared with copies
+    int count = 0;                          // Vertices this copy covers
+
+    static int bucketOf(int load);
+    void own(int capacity);                 // Unshared storage with room for capacity
+    void add(int bucket, int delta);
+    int prefix(int buckets) const;          // Count in buckets [0, buckets)
+};
+
+#endif // PATIENT_LOAD_INDEX_H
@@ -0,0 +1,64 @@
+#include "string_pool.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+using namespace std;
+
+const size_t StringPool::CHUNK_BYTES;
+
+static bool sameText(const char* interned, string_view text) {
+    return strncmp(interned, text.data(), text.size()) == 0 && interned[text.size()] == '\0';
+}
+
+const char* StringPool::intern(string_view text) {
+    if ((count + 1) * 2 > slots.size()) grow();
+
+    size_t mask = slots.size() - 1;
+    size_t slot = hash<string_view>()(text) & mask;
+    while (slots[slot]) {
+        if (sameText(slots[slot], text)) return slots[slot];
+        slot = (slot + 1) & mask;
+    }
+
+    char* copy = allocate(text.size() + 1);
+    memcpy(copy, text.data(), text.size());
+    copy[text.size()] = '\0';
+    slots[slot] = copy;
+    count++;
+    return copy;
+}
+
+void StringPool::grow() {
+    vector<const char*> old(max<size_t>(64, slots.size() * 2), nullptr);
+    old.swap(slots);
+
+    size_t mask = slots.size() - 1;
+    for (const char* text : old) {
+        if (!text) continue;
+        size_t slot = hash<string_view>()(string_view(text)) & mask;
+        while (slots[slot]) slot = (slot + 1) & mask;
+        slots[slot] = text;
+    }
+}
+
+// Bump allocation; a string too large for a chunk gets a block of its own
+char* StringPool::allocate(size_t bytes) {
+    if (bytes > CHUNK_BYTES / 4) {
+        large.emplace_back(new char[bytes]);
+        largeBytes += bytes;
+        return large.back().get();
+    }
+
+    if (chunkUsed + bytes > CHUNK_BYTES) {
+        chunks.emplace_back(new char[CHUNK_BYTES]);
+        chunkUsed = 0;
+    }
+    char* result = chunks.back().get() + chunkUsed;
+    chunkUsed += bytes;
+    return result;
+}
+
+size_t StringPool::bytesReserved() const {
+    return chunks.size() * CHUNK_BYTES + largeBytes;
+}
@@ -0,0 +1,56 @@
+/**
+ * String Pool Header
+ *
+ * Interning table for the text of a hospital network: IDs, names,
+ * locations and connection descriptions. Each distinct string is stored
+ * once, NUL-terminated, in large arena chunks, and callers keep a plain
+ * const char* to it. A description such as "ambulance route" that appears
+ * on thousands of connections costs its bytes only once.
+ *
+ * Interned strings never move and are never freed one by one: the whole
+ * arena is released in one go when the pool is destroyed. An owner whose
+ * text changes over time repacks by interning its live strings into a new
+ * pool and dropping the old one. Interning is for a single writer; strings
+ * already handed out may be read from any thread.
+ */
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+class StringPool {
+public:
+    static const size_t CHUNK_BYTES = 64 * 1024;
+
+    StringPool() = default;
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+
+    // Stable copy of text; equal strings return the same pointer
+    const char* intern(string_view text);
+
+    size_t stringCount() const { return count; }
+    size_t bytesReserved() const;
+
+private:
+    vector<unique_ptr<char[]>> chunks;      // CHUNK_BYTES each
+    vector<unique_ptr<char[]>> large;       // One oversized string each
+    size_t chunkUsed = CHUNK_BYTES;         // Bytes used in chunks.back()
+    size_t largeBytes = 0;
+
+    // Open-addressing hash table of interned strings (linear probing,
+    // at most half full): 8 bytes per slot instead of a node per string
+    vector<const char*> slots;
+    size_t count = 0;
+
+    char* allocate(size_t bytes);
+    void grow();
+};
+
+#endif // STRING_POOL_H